@@ -8,11 +8,14 @@ SPDX-License-Identifier: Apache-2.0
 
 #include <climits>
 #include <compare>
+#include <functional>
 #include <iostream>
 #include <span>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "impl-bi_api.hpp"
 #include "impl-bi_digit_vector.hpp"
 
 // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
@@ -20,16 +23,6 @@ SPDX-License-Identifier: Apache-2.0
 static_assert(sizeof(double) * CHAR_BIT == 64, "64-bit double is assumed.");
 static_assert(-1 == ~0, "Two's complement representation assumed.");
 
-#if defined(_WIN32)
-#if defined(BI_API_EXPORTS)
-#define BI_API __declspec(dllexport)
-#else
-#define BI_API __declspec(dllimport)
-#endif
-#else
-#define BI_API
-#endif
-
 #if defined(BI_FORCE_64_BIT) && defined(__SIZEOF_INT128__)
 #define BI_DIGIT_64_BIT
 #elif defined(BI_FORCE_32_BIT)
@@ -49,6 +42,16 @@ using digit = uint32_t;
 using bi_bitcount_t = unsigned long;
 using dvector = digit_vector<digit, bi_bitcount_t>;
 
+enum class rounding {
+  half_even,
+  half_away_from_zero,
+  half_toward_zero,
+  toward_zero,
+  away_from_zero,
+  floor,
+  ceil
+};
+
 class BI_API bi_t {
  public:
   // Constructors
@@ -59,7 +62,8 @@ class BI_API bi_t {
   bi_t(bi_t&& other) noexcept;
   explicit bi_t(const std::string&, int base = 10);
   explicit bi_t(const char*, int base = 10);
-  bi_t(double);  // NOLINT(runtime/explicit)
+  bi_t(double);       // NOLINT(runtime/explicit)
+  bi_t(long double);  // NOLINT(runtime/explicit)
 
   ~bi_t() = default;
 
@@ -71,6 +75,7 @@ class BI_API bi_t {
   bi_t& operator=(const std::string&);
   bi_t& operator=(const char*);
   bi_t& operator=(double);
+  bi_t& operator=(long double);
 
   // Unary operators
   bi_t operator+() const;
@@ -90,12 +95,19 @@ class BI_API bi_t {
   bi_t& operator/=(const bi_t&);
   bi_t& operator%=(const bi_t&);
   std::pair<bi_t, bi_t> div(const bi_t&) const;
+  digit mod_ui(digit) const;
+  void mod_ui(std::span<const digit> moduli, std::span<digit> residues) const;
+  bool divisible_by(digit) const noexcept;
 
   // Additive operators
   bi_t operator+(const bi_t&) const;
   bi_t operator-(const bi_t&) const;
   bi_t& operator+=(const bi_t&);
   bi_t& operator-=(const bi_t&);
+  template <std::integral T>
+  bi_t& operator+=(T);
+  template <std::integral T>
+  bi_t& operator-=(T);
 
   // Shift operators
   bi_t operator<<(bi_bitcount_t shift) const;
@@ -132,12 +144,22 @@ class BI_API bi_t {
   explicit operator bool() const noexcept;
   template <std::integral T>
   explicit operator T() const noexcept;
+  explicit operator float() const noexcept;
   explicit operator double() const noexcept;
+  explicit operator long double() const noexcept;
+  float to_float(rounding mode = rounding::half_even) const noexcept;
+  double to_double(rounding mode = rounding::half_even) const noexcept;
+  long double to_long_double(
+      rounding mode = rounding::half_even) const noexcept;
 
   // Bits
   bi_bitcount_t bit_length() const noexcept;
   bool test_bit(bi_bitcount_t) const noexcept;
   bi_t& set_bit(bi_bitcount_t);
+  bool is_pow2() const noexcept;
+  bi_t& mod_pow2(bi_bitcount_t k) noexcept;
+  bi_t& div_pow2_trunc(bi_bitcount_t k) noexcept;
+  bi_t& div_pow2_floor(bi_bitcount_t k);
 
   // Accessors for internal representation
   size_t capacity() const noexcept;
@@ -181,6 +203,18 @@ class BI_API bi_t {
   const digit& operator[](size_t index) const;
   void resize_unsafe_(size_t new_size);
   void trim() noexcept;
+  bool add_digit_(digit magnitude, bool negative) noexcept;
+  void increment_();
+  void decrement_();
+
+  // Single-digit cases and out-of-line general cases of the operators that
+  // impl-bi_fast.inl defines inline
+  bool add_small_(const bi_t& a, const bi_t& b, bool subtract);
+  bool mul_small_(const bi_t& a, const bi_t& b);
+  static void add_general_(bi_t& result, const bi_t& a, const bi_t& b);
+  static void sub_general_(bi_t& result, const bi_t& a, const bi_t& b);
+  static void mul_general_(bi_t& result, const bi_t& a, const bi_t& b);
+  static int cmp_general_(const bi_t& a, const bi_t& b) noexcept;
 
   auto begin() noexcept;
   auto begin() const noexcept;
@@ -193,19 +227,48 @@ class BI_API bi_t {
 
   /// @cond
   friend struct h_;
+  friend class accumulator;
   /// @endcond
 };
 
 BI_API std::ostream& operator<<(std::ostream&, const bi_t&);
 
 BI_API void swap(bi_t& a, bi_t& b) noexcept;
+BI_API size_t hash_value(const bi_t& x) noexcept;
 BI_API bi_t operator"" _bi(const char* str);
 BI_API bi_t abs(const bi_t& value);
+BI_API bi_t gcd(const bi_t& a, const bi_t& b);
+BI_API bi_t mul_low(const bi_t& a, const bi_t& b, size_t n);
+BI_API bi_t mul_high(const bi_t& a, const bi_t& b, size_t n);
+BI_API void addmul(bi_t& acc, const bi_t& a, const bi_t& b);
+BI_API void submul(bi_t& acc, const bi_t& a, const bi_t& b);
+BI_API std::vector<bi_t> poly_mul(std::span<const bi_t> a,
+                                   std::span<const bi_t> b);
+BI_API bi_t divexact(const bi_t& a, const bi_t& d);
+BI_API bi_t div_floor(const bi_t& a, const bi_t& b);
+BI_API bi_t div_ceil(const bi_t& a, const bi_t& b);
+BI_API bi_t div_euclid(const bi_t& a, const bi_t& b);
+BI_API bi_t mod_euclid(const bi_t& a, const bi_t& b);
+BI_API std::pair<bi_t, bi_t> divmod_floor(const bi_t& a, const bi_t& b);
+BI_API std::pair<bi_t, bi_t> divmod_ceil(const bi_t& a, const bi_t& b);
+BI_API std::pair<bi_t, bi_t> divmod_euclid(const bi_t& a, const bi_t& b);
+BI_API bi_t powmod(const bi_t& base, const bi_t& exp, const bi_t& m);
+BI_API int jacobi(const bi_t& a, const bi_t& n);
+BI_API int kronecker(const bi_t& a, const bi_t& n);
+BI_API bi_t sqrtmod(const bi_t& a, const bi_t& p);
 
 }  // namespace bi
 
+template <>
+struct std::hash<bi::bi_t> {
+  size_t operator()(const bi::bi_t& x) const noexcept {
+    return bi::hash_value(x);
+  }
+};
+
 // NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
 
 #endif  // BI_INCLUDE_BI_HPP_
 
 #include "impl-bi.inl"
+#include "impl-bi_fast.inl"
@@ -0,0 +1,50 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef BI_INCLUDE_BI_ACCUMULATOR_HPP_
+#define BI_INCLUDE_BI_ACCUMULATOR_HPP_
+
+#include <span>
+#include <vector>
+
+#include "bi.hpp"
+
+namespace bi {
+
+class BI_API accumulator {
+ public:
+  // Constructors
+  accumulator();
+  explicit accumulator(const bi_t& initial);
+
+  // Arithmetic operators
+  accumulator& operator+=(const bi_t&);
+  accumulator& operator-=(const bi_t&);
+
+  // Accessors
+  bi_t value() const;
+
+  // Other
+  void clear() noexcept;
+  void swap(accumulator&) noexcept;
+
+ private:
+  // Column i is the signed two's complement double-digit integer with low
+  // digit columns_[2 * i] and high digit columns_[2 * i + 1]
+  std::vector<digit> columns_;
+  // Additions and subtractions since the columns were last normalized
+  size_t pending_;
+
+  void add_(const bi_t& x, bool subtract);
+  void assign_(const bi_t& x);
+};
+
+BI_API bi_t sum(std::span<const bi_t> values);
+
+BI_API void swap(accumulator& a, accumulator& b) noexcept;
+
+}  // namespace bi
+
+#endif  // BI_INCLUDE_BI_ACCUMULATOR_HPP_
@@ -0,0 +1,98 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef BI_INCLUDE_BI_BIGFLOAT_HPP_
+#define BI_INCLUDE_BI_BIGFLOAT_HPP_
+
+#include <compare>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "bi.hpp"
+
+namespace bi {
+
+class BI_API bigfloat {
+ public:
+  static constexpr bi_bitcount_t default_precision = 53;
+
+  // Constructors
+  bigfloat();
+  explicit bigfloat(const bi_t& mantissa, int64_t exponent = 0,
+                    bi_bitcount_t precision = default_precision,
+                    rounding mode = rounding::half_even);
+  explicit bigfloat(double, bi_bitcount_t precision = default_precision,
+                    rounding mode = rounding::half_even);
+
+  // Accessors
+  const bi_t& mantissa() const noexcept;
+  int64_t exponent() const noexcept;
+  bi_bitcount_t precision() const noexcept;
+  bigfloat& set_precision(bi_bitcount_t precision,
+                          rounding mode = rounding::half_even);
+
+  // Unary operators
+  bigfloat operator+() const;
+  bigfloat operator-() const;
+
+  // Arithmetic operators
+  bigfloat operator+(const bigfloat&) const;
+  bigfloat operator-(const bigfloat&) const;
+  bigfloat operator*(const bigfloat&) const;
+  bigfloat operator/(const bigfloat&) const;
+  bigfloat& operator+=(const bigfloat&);
+  bigfloat& operator-=(const bigfloat&);
+  bigfloat& operator*=(const bigfloat&);
+  bigfloat& operator/=(const bigfloat&);
+
+  // Comparisons
+  std::weak_ordering operator<=>(const bigfloat&) const;
+  bool operator==(const bigfloat&) const;
+
+  // Conversion operators
+  explicit operator double() const;
+
+  // Other
+  void swap(bigfloat&) noexcept;
+  std::string to_string(size_t digits = 0) const;
+  int sign() const noexcept;
+
+  /* Static */
+  // Correctly rounded operations
+  static bigfloat add(const bigfloat& a, const bigfloat& b,
+                      bi_bitcount_t precision,
+                      rounding mode = rounding::half_even);
+  static bigfloat sub(const bigfloat& a, const bigfloat& b,
+                      bi_bitcount_t precision,
+                      rounding mode = rounding::half_even);
+  static bigfloat mul(const bigfloat& a, const bigfloat& b,
+                      bi_bitcount_t precision,
+                      rounding mode = rounding::half_even);
+  static bigfloat div(const bigfloat& a, const bigfloat& b,
+                      bi_bitcount_t precision,
+                      rounding mode = rounding::half_even);
+  static bigfloat sqrt(const bigfloat& x, bi_bitcount_t precision,
+                       rounding mode = rounding::half_even);
+  static bigfloat sqrt(const bigfloat& x);
+
+ private:
+  bi_t mant_;
+  int64_t exp_;
+  bi_bitcount_t prec_;
+
+  void assign_rounded_(bi_t magnitude, int64_t exponent, bool negative,
+                       bool sticky, bi_bitcount_t precision, rounding mode);
+  static bigfloat add_(const bigfloat& a, const bigfloat& b, bool subtract,
+                       bi_bitcount_t precision, rounding mode);
+};
+
+BI_API std::ostream& operator<<(std::ostream&, const bigfloat&);
+
+BI_API void swap(bigfloat& a, bigfloat& b) noexcept;
+
+}  // namespace bi
+
+#endif  // BI_INCLUDE_BI_BIGFLOAT_HPP_
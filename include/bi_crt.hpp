@@ -0,0 +1,51 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef BI_INCLUDE_BI_CRT_HPP_
+#define BI_INCLUDE_BI_CRT_HPP_
+
+#include <span>
+#include <vector>
+
+#include "bi.hpp"
+
+namespace bi {
+
+class BI_API crt_context {
+ public:
+  // Constructors
+  explicit crt_context(std::span<const digit> moduli);
+
+  // Accessors
+  size_t size() const noexcept;
+  std::span<const digit> moduli() const noexcept;
+  const bi_t& modulus() const noexcept;
+
+  // Conversions
+  bi_t crt(std::span<const digit> residues) const;
+  void multi_mod(const bi_t& x, std::span<digit> residues) const;
+  std::vector<digit> multi_mod(const bi_t& x) const;
+
+ private:
+  std::vector<digit> moduli_;
+  // tree_[0] holds the moduli; each node of tree_[h + 1] is the product of two
+  // adjacent nodes of tree_[h] (or a copy of the last, odd one)
+  std::vector<std::vector<bi_t>> tree_;
+  // Barrett reciprocals of the nodes above the leaves
+  std::vector<std::vector<bi_t>> reciprocals_;
+  // Inverse of modulus() / moduli_[i] modulo moduli_[i]
+  std::vector<digit> cofactor_inverses_;
+
+  void reduce_(bi_t& r, size_t level, size_t index) const;
+};
+
+BI_API bi_t crt(std::span<const digit> residues,
+                std::span<const digit> moduli);
+BI_API std::vector<digit> multi_mod(const bi_t& x,
+                                    std::span<const digit> moduli);
+
+}  // namespace bi
+
+#endif  // BI_INCLUDE_BI_CRT_HPP_
@@ -0,0 +1,76 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef BI_INCLUDE_BI_DECIMAL_HPP_
+#define BI_INCLUDE_BI_DECIMAL_HPP_
+
+#include <compare>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "bi.hpp"
+
+namespace bi {
+
+class BI_API decimal {
+ public:
+  // Constructors
+  decimal();
+  decimal(const bi_t& coeff, int32_t exp = 0);  // NOLINT(runtime/explicit)
+  template <std::integral T>
+  decimal(T value)  // NOLINT(runtime/explicit)
+      : coeff_(value), exp_(0) {}
+  explicit decimal(const std::string&);
+  explicit decimal(const char*);
+
+  // Accessors
+  const bi_t& coefficient() const noexcept;
+  int32_t exponent() const noexcept;
+  int32_t scale() const noexcept;
+
+  // Rounding
+  decimal rescale(int32_t exponent, rounding mode = rounding::half_even) const;
+  decimal with_scale(int32_t scale, rounding mode = rounding::half_even) const;
+
+  // Unary operators
+  decimal operator+() const;
+  decimal operator-() const;
+
+  // Arithmetic operators
+  decimal operator+(const decimal&) const;
+  decimal operator-(const decimal&) const;
+  decimal operator*(const decimal&) const;
+  decimal& operator+=(const decimal&);
+  decimal& operator-=(const decimal&);
+  decimal& operator*=(const decimal&);
+
+  // Comparisons
+  std::weak_ordering operator<=>(const decimal&) const;
+  bool operator==(const decimal&) const;
+
+  // Other
+  void swap(decimal&) noexcept;
+  std::string to_string() const;
+  int sign() const noexcept;
+
+  /* Static */
+  static decimal div(const decimal& a, const decimal& b, int32_t exponent,
+                     rounding mode = rounding::half_even);
+
+ private:
+  bi_t coeff_;
+  int32_t exp_;
+
+  decimal& add_(const decimal& other, bool subtract);
+};
+
+BI_API std::ostream& operator<<(std::ostream&, const decimal&);
+
+BI_API void swap(decimal& a, decimal& b) noexcept;
+
+}  // namespace bi
+
+#endif  // BI_INCLUDE_BI_DECIMAL_HPP_
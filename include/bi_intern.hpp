@@ -0,0 +1,59 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef BI_INCLUDE_BI_INTERN_HPP_
+#define BI_INCLUDE_BI_INTERN_HPP_
+
+#include <functional>
+#include <iostream>
+#include <memory>
+
+#include "bi.hpp"
+
+namespace bi {
+
+class BI_API interned {
+ public:
+  // Constructors
+  interned();
+
+  // Accessors
+  const bi_t& get() const noexcept;
+  const bi_t& operator*() const noexcept;
+  const bi_t* operator->() const noexcept;
+
+  // Comparisons
+  bool operator==(const interned&) const noexcept;
+
+  // Other
+  void swap(interned&) noexcept;
+
+ private:
+  std::shared_ptr<const bi_t> ptr_;
+
+  explicit interned(std::shared_ptr<const bi_t> ptr) noexcept;
+
+  /// @cond
+  friend BI_API interned intern(const bi_t& x);
+  /// @endcond
+};
+
+BI_API interned intern(const bi_t& x);
+BI_API size_t interned_count() noexcept;
+
+BI_API std::ostream& operator<<(std::ostream&, const interned&);
+
+BI_API void swap(interned& a, interned& b) noexcept;
+
+}  // namespace bi
+
+template <>
+struct std::hash<bi::interned> {
+  size_t operator()(const bi::interned& x) const noexcept {
+    return std::hash<const bi::bi_t*>{}(&x.get());
+  }
+};
+
+#endif  // BI_INCLUDE_BI_INTERN_HPP_
@@ -0,0 +1,65 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef BI_INCLUDE_BI_MATRIX_HPP_
+#define BI_INCLUDE_BI_MATRIX_HPP_
+
+#include <initializer_list>
+#include <iostream>
+#include <span>
+#include <vector>
+
+#include "bi.hpp"
+
+namespace bi {
+
+class BI_API matrix {
+ public:
+  // Constructors
+  matrix();
+  matrix(size_t rows, size_t cols);
+  matrix(std::initializer_list<std::initializer_list<bi_t>> rows);
+  static matrix identity(size_t n);
+
+  // Accessors
+  size_t rows() const noexcept;
+  size_t cols() const noexcept;
+  bi_t& operator()(size_t i, size_t j);
+  const bi_t& operator()(size_t i, size_t j) const;
+  std::span<bi_t> row(size_t i);
+  std::span<const bi_t> row(size_t i) const;
+
+  // Unary operators
+  matrix operator+() const;
+  matrix operator-() const;
+
+  // Arithmetic operators
+  matrix operator+(const matrix&) const;
+  matrix operator-(const matrix&) const;
+  matrix operator*(const matrix&) const;
+  matrix& operator+=(const matrix&);
+  matrix& operator-=(const matrix&);
+  matrix& operator*=(const matrix&);
+
+  // Comparisons
+  bool operator==(const matrix&) const;
+
+  // Other
+  void swap(matrix&) noexcept;
+
+ private:
+  size_t rows_;
+  size_t cols_;
+  // Row-major entries
+  std::vector<bi_t> data_;
+};
+
+BI_API std::ostream& operator<<(std::ostream&, const matrix&);
+
+BI_API void swap(matrix& a, matrix& b) noexcept;
+
+}  // namespace bi
+
+#endif  // BI_INCLUDE_BI_MATRIX_HPP_
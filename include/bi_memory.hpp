@@ -0,0 +1,27 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef BI_INCLUDE_BI_MEMORY_HPP_
+#define BI_INCLUDE_BI_MEMORY_HPP_
+
+#include <cstddef>
+
+#include "bi.hpp"
+
+namespace bi {
+
+struct allocation_policy {
+  // Digit arrays of at least this many bytes are backed by huge pages
+  size_t huge_page_threshold = size_t{8} << 20;
+  // Map explicitly reserved 2 MiB pages rather than transparent huge pages
+  bool explicit_huge_pages = false;
+};
+
+BI_API allocation_policy get_allocation_policy() noexcept;
+BI_API void set_allocation_policy(const allocation_policy& policy) noexcept;
+
+}  // namespace bi
+
+#endif  // BI_INCLUDE_BI_MEMORY_HPP_
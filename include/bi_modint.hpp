@@ -0,0 +1,585 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef BI_INCLUDE_BI_MODINT_HPP_
+#define BI_INCLUDE_BI_MODINT_HPP_
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "bi.hpp"
+#include "bi_exceptions.hpp"
+
+namespace bi {
+
+/**
+ *  @class montgomery
+ *  @headerfile "bi_modint.hpp"
+ *  @brief Montgomery arithmetic modulo a fixed odd modulus of at most `N`
+ *  digits.
+ *
+ *  Residues are `std::array<digit, N>` (least significant digit first) in
+ *  *Montgomery form*: the residue of \f$ x \f$ is stored as
+ *  \f$ xR \bmod m \f$, where \f$ R = 2^{N w} \f$ for \f$ w \f$-bit digits.
+ *  The product of two residues is then \f$ abR^{-1} \bmod m \f$, which
+ *  Montgomery reduction computes with multiplications and shifts only, one
+ *  digit at a time, interleaved with the multiplication (CIOS). Sums and
+ *  differences of residues need at most one correction by \f$ m \f$.
+ *
+ *  All operations on residues work in place on fixed-width arrays, so that
+ *  they never allocate. Only `encode()` of a `bi_t` that is not already
+ *  reduced, and `decode()`, use `bi_t` arithmetic.
+ *
+ *  @throw std::invalid_argument Throws if the modulus is not odd and positive
+ *  or does not fit in `N` digits.
+ *  @throw bi::division_by_zero Throws if `inv()` is given a residue that is
+ *  not invertible.
+ */
+template <size_t N>
+class montgomery {
+  static_assert(N > 0, "A modulus has at least one digit.");
+
+ public:
+  using limbs = std::array<digit, N>;
+
+  /// Construct the context for the odd `modulus`, given by its digits.
+  constexpr explicit montgomery(const limbs& modulus) : m_(modulus) {
+    if (m_[0] % 2 == 0) {
+      throw std::invalid_argument("Modulus must be odd.");
+    }
+
+    // Newton's iteration doubles the number of correct low bits of the
+    // inverse; an odd number is its own inverse modulo 8
+    digit inverse = m_[0];
+    for (int i = 0; i < 6; ++i) {
+      inverse *= 2 - m_[0] * inverse;
+    }
+    m_inv_ = digit{0} - inverse;
+
+    // R mod m and R^2 mod m, by doubling 1 (which is 0 if m = 1)
+    limbs x{1};
+    if (!less_(x, m_)) {
+      x = limbs{};
+    }
+    for (size_t i = 0; i < N * digit_bits_; ++i) {
+      x = add(x, x);
+    }
+    one_ = x;
+    for (size_t i = 0; i < N * digit_bits_; ++i) {
+      x = add(x, x);
+    }
+    r2_ = x;
+    r3_ = mul(r2_, r2_);
+  }
+
+  /// Construct the context for the odd, positive `modulus`.
+  explicit montgomery(const bi_t& modulus) : montgomery(to_limbs_(modulus)) {}
+
+  /// Return the digits of the modulus.
+  constexpr const limbs& modulus() const noexcept { return m_; }
+
+  /// Return the residue of 1.
+  constexpr const limbs& one() const noexcept { return one_; }
+
+  /// Return the residue of `a + b`.
+  constexpr limbs add(const limbs& a, const limbs& b) const noexcept {
+    limbs r = a;
+    if (add_in_place_(r, b) != 0 || !less_(r, m_)) {
+      sub_in_place_(r, m_);
+    }
+    return r;
+  }
+
+  /// Return the residue of `a - b`.
+  constexpr limbs sub(const limbs& a, const limbs& b) const noexcept {
+    limbs r = a;
+    if (sub_in_place_(r, b) != 0) {
+      add_in_place_(r, m_);
+    }
+    return r;
+  }
+
+  /// Return the residue of `-a`.
+  constexpr limbs neg(const limbs& a) const noexcept {
+    if (a == limbs{}) {
+      return a;
+    }
+    limbs r = m_;
+    sub_in_place_(r, a);
+    return r;
+  }
+
+  /// Return the residue of `a * b`.
+  constexpr limbs mul(const limbs& a, const limbs& b) const noexcept {
+    std::array<digit, N + 2> t{};
+    for (size_t i = 0; i < N; ++i) {
+      // t += a * b[i]
+      digit carry = 0;
+      for (size_t j = 0; j < N; ++j) {
+        carry = mul_add_(a[j], b[i], t[j], carry, t[j]);
+      }
+      t[N] += carry;
+      t[N + 1] = t[N] < carry;
+
+      // t = (t + q * m) / 2^w, where q makes the sum divisible by 2^w
+      const digit q = t[0] * m_inv_;
+      digit discarded = 0;
+      carry = mul_add_(q, m_[0], t[0], 0, discarded);
+      for (size_t j = 1; j < N; ++j) {
+        carry = mul_add_(q, m_[j], t[j], carry, t[j - 1]);
+      }
+      t[N - 1] = t[N] + carry;
+      t[N] = t[N + 1] + (t[N - 1] < carry);
+    }
+
+    limbs r;
+    std::copy(t.begin(), t.begin() + N, r.begin());
+    if (t[N] != 0 || !less_(r, m_)) {
+      sub_in_place_(r, m_);
+    }
+    return r;
+  }
+
+  /// Return the residue of `a^exp`, for the digits `exp` of the exponent.
+  constexpr limbs pow(const limbs& a,
+                      std::span<const digit> exp) const noexcept {
+    limbs r = one_;
+    bool started = false;
+    for (size_t i = exp.size(); i-- > 0;) {
+      for (size_t bit = digit_bits_; bit-- > 0;) {
+        if (started) {
+          r = mul(r, r);
+        }
+        if (((exp[i] >> bit) & 1) != 0) {
+          r = started ? mul(r, a) : a;
+          started = true;
+        }
+      }
+    }
+    return r;
+  }
+
+  /**
+   *  Return the residue of the inverse of `a`, found by the binary extended
+   *  Euclidean algorithm on the stored value \f$ aR \f$, whose inverse
+   *  \f$ a^{-1}R^{-1} \f$ is brought back to Montgomery form by a product
+   *  with \f$ R^{3} \f$.
+   */
+  constexpr limbs inv(const limbs& a) const {
+    if (one_ == limbs{}) {
+      return a;
+    }
+
+    // x1 * a == u and x2 * a == v (mod m) throughout
+    limbs u = a;
+    limbs v = m_;
+    limbs x1{1};
+    limbs x2{};
+    while (!is_one_(u) && !is_one_(v)) {
+      if (u == limbs{}) {
+        throw division_by_zero("Residue is not invertible.");
+      }
+      while (u[0] % 2 == 0) {
+        shift_right_1_(u, 0);
+        halve_(x1);
+      }
+      while (v[0] % 2 == 0) {
+        shift_right_1_(v, 0);
+        halve_(x2);
+      }
+      if (!less_(u, v)) {
+        sub_in_place_(u, v);
+        x1 = sub(x1, x2);
+      } else {
+        sub_in_place_(v, u);
+        x2 = sub(x2, x1);
+      }
+    }
+    return mul(is_one_(u) ? x1 : x2, r3_);
+  }
+
+  /// Return the Montgomery form of `x < m`.
+  constexpr limbs to_montgomery(const limbs& x) const noexcept {
+    return mul(x, r2_);
+  }
+
+  /// Return the least nonnegative value of the residue `x`.
+  constexpr limbs from_montgomery(const limbs& x) const noexcept {
+    return mul(x, limbs{1});
+  }
+
+  /// Return the residue of `x`.
+  limbs encode(const bi_t& x) const {
+    limbs r{};
+    if (!x.negative() && x.size() <= N) {
+      std::ranges::copy(x.digits(), r.begin());
+      if (less_(r, m_)) {
+        return to_montgomery(r);
+      }
+    }
+    const bi_t reduced = mod_euclid(x, to_bi_(m_));
+    r = limbs{};
+    std::ranges::copy(reduced.digits(), r.begin());
+    return to_montgomery(r);
+  }
+
+  /// Return the residue of `x`, without `bi_t` arithmetic if `|x| < m`.
+  template <std::integral T>
+  limbs encode(T x) const {
+    using U = std::make_unsigned_t<T>;
+    if constexpr (sizeof(U) <= sizeof(limbs)) {
+      const bool negative = std::cmp_less(x, 0);
+      U magnitude = negative ? U(0) - static_cast<U>(x) : static_cast<U>(x);
+      limbs r{};
+      for (size_t i = 0; i < N && magnitude != 0; ++i) {
+        r[i] = static_cast<digit>(magnitude);
+        if constexpr (sizeof(U) > sizeof(digit)) {
+          magnitude >>= digit_bits_;
+        } else {
+          magnitude = 0;
+        }
+      }
+      if (less_(r, m_)) {
+        r = to_montgomery(r);
+        return negative ? neg(r) : r;
+      }
+    }
+    return encode(bi_t(x));
+  }
+
+  /// Return the least nonnegative value of the residue `x`.
+  bi_t decode(const limbs& x) const { return to_bi_(from_montgomery(x)); }
+
+  /// Return the modulus.
+  bi_t modulus_bi() const { return to_bi_(m_); }
+
+ private:
+#if defined(BI_DIGIT_64_BIT)
+  __extension__ typedef unsigned __int128 wide_;  // NOLINT
+#else
+  using wide_ = uint64_t;
+#endif
+  static constexpr size_t digit_bits_ = std::numeric_limits<digit>::digits;
+
+  limbs m_;
+  // -m^{-1} mod 2^w
+  digit m_inv_ = 0;
+  // R, R^2 and R^3 mod m
+  limbs one_{};
+  limbs r2_{};
+  limbs r3_{};
+
+  /// Set `low` to the low digit of `a * b + c + d` and return the high digit.
+  static constexpr digit mul_add_(digit a, digit b, digit c, digit d,
+                                  digit& low) noexcept {
+    const wide_ p = static_cast<wide_>(a) * b + c + d;
+    low = static_cast<digit>(p);
+    return static_cast<digit>(p >> digit_bits_);
+  }
+
+  /// Add `y` to `x` and return the carry out.
+  static constexpr digit add_in_place_(limbs& x, const limbs& y) noexcept {
+    digit carry = 0;
+    for (size_t i = 0; i < N; ++i) {
+      const digit s = x[i] + carry;
+      carry = s < carry;
+      x[i] = s + y[i];
+      carry += x[i] < s;
+    }
+    return carry;
+  }
+
+  /// Subtract `y` from `x` and return the borrow out.
+  static constexpr digit sub_in_place_(limbs& x, const limbs& y) noexcept {
+    digit borrow = 0;
+    for (size_t i = 0; i < N; ++i) {
+      const digit d = x[i] - borrow;
+      borrow = d > x[i];
+      x[i] = d - y[i];
+      borrow += x[i] > d;
+    }
+    return borrow;
+  }
+
+  /// Shift `x` right by one bit, shifting in the low bit of `high`.
+  static constexpr void shift_right_1_(limbs& x, digit high) noexcept {
+    for (size_t i = 0; i < N; ++i) {
+      const digit next = i + 1 < N ? x[i + 1] : high;
+      x[i] = (x[i] >> 1) | (next << (digit_bits_ - 1));
+    }
+  }
+
+  /// Set `x < m` to `x / 2 mod m`.
+  constexpr void halve_(limbs& x) const noexcept {
+    digit carry = 0;
+    if (x[0] % 2 != 0) {
+      carry = add_in_place_(x, m_);
+    }
+    shift_right_1_(x, carry);
+  }
+
+  static constexpr bool less_(const limbs& x, const limbs& y) noexcept {
+    for (size_t i = N; i-- > 0;) {
+      if (x[i] != y[i]) {
+        return x[i] < y[i];
+      }
+    }
+    return false;
+  }
+
+  static constexpr bool is_one_(const limbs& x) noexcept {
+    return x == limbs{1};
+  }
+
+  static limbs to_limbs_(const bi_t& x) {
+    if (x <= 0 || x.size() > N) {
+      throw std::invalid_argument("Modulus must be positive and fit in N "
+                                  "digits.");
+    }
+    limbs r{};
+    std::ranges::copy(x.digits(), r.begin());
+    return r;
+  }
+
+  static bi_t to_bi_(const limbs& x) {
+    bi_t r;
+    for (size_t i = N; i-- > 0;) {
+      r <<= digit_bits_;
+      r += x[i];
+    }
+    return r;
+  }
+};
+
+/// @cond
+namespace modint_detail {
+
+/// Return the digits of the modulus given to `modint`.
+template <auto Modulus>
+constexpr auto digits_of() noexcept {
+  if constexpr (std::integral<decltype(Modulus)>) {
+    static_assert(Modulus > 0, "Modulus must be positive.");
+    using U = std::make_unsigned_t<decltype(Modulus)>;
+    constexpr auto value = static_cast<U>(Modulus);
+    constexpr size_t width = std::numeric_limits<U>::digits;
+    constexpr size_t digit_bits = std::numeric_limits<digit>::digits;
+    constexpr size_t n = [] {
+      size_t count = 1;
+      while (count * digit_bits < width &&
+             (value >> (count * digit_bits)) != 0) {
+        ++count;
+      }
+      return count;
+    }();
+    std::array<digit, n> r{};
+    U rest = value;
+    for (size_t i = 0; i < n; ++i) {
+      r[i] = static_cast<digit>(rest);
+      if constexpr (width > digit_bits) {
+        rest >>= digit_bits;
+      }
+    }
+    return r;
+  } else {
+    return Modulus;
+  }
+}
+
+template <auto Modulus>
+inline constexpr size_t size_of = digits_of<Modulus>().size();
+
+}  // namespace modint_detail
+
+/**
+ *  Operations shared by `modint` and `dyn_modint`, which store a residue in
+ *  Montgomery form and provide its context through `context()`.
+ */
+template <typename Derived, size_t N>
+class modint_base {
+ public:
+  using limbs = typename montgomery<N>::limbs;
+
+  // Unary operators
+  Derived operator+() const noexcept { return self_(); }
+  Derived operator-() const noexcept {
+    return with_(ctx_().neg(value_));
+  }
+
+  // Arithmetic operators
+  Derived& operator+=(const Derived& other) noexcept {
+    value_ = ctx_().add(value_, other.value_);
+    return self_();
+  }
+  Derived& operator-=(const Derived& other) noexcept {
+    value_ = ctx_().sub(value_, other.value_);
+    return self_();
+  }
+  Derived& operator*=(const Derived& other) noexcept {
+    value_ = ctx_().mul(value_, other.value_);
+    return self_();
+  }
+  Derived& operator/=(const Derived& other) {
+    value_ = ctx_().mul(value_, ctx_().inv(other.value_));
+    return self_();
+  }
+  friend Derived operator+(Derived a, const Derived& b) noexcept {
+    return a += b;
+  }
+  friend Derived operator-(Derived a, const Derived& b) noexcept {
+    return a -= b;
+  }
+  friend Derived operator*(Derived a, const Derived& b) noexcept {
+    return a *= b;
+  }
+  friend Derived operator/(Derived a, const Derived& b) { return a /= b; }
+
+  // Comparisons
+  friend bool operator==(const Derived& a, const Derived& b) noexcept {
+    return a.value_ == b.value_;
+  }
+
+  // Exponentiation and inverse
+  Derived inv() const { return with_(ctx_().inv(value_)); }
+  Derived pow(const bi_t& exp) const {
+    const Derived base = exp.negative() ? inv() : self_();
+    return with_(ctx_().pow(base.value_, exp.digits()));
+  }
+  template <std::integral T>
+  Derived pow(T exp) const {
+    using U = std::make_unsigned_t<T>;
+    constexpr size_t digit_bits = std::numeric_limits<digit>::digits;
+    constexpr size_t n = (sizeof(U) + sizeof(digit) - 1) / sizeof(digit);
+    const bool negative = std::cmp_less(exp, 0);
+    const Derived base = negative ? inv() : self_();
+    U magnitude = negative ? U(0) - static_cast<U>(exp) : static_cast<U>(exp);
+    std::array<digit, n> digits{};
+    for (size_t i = 0; i < n; ++i) {
+      digits[i] = static_cast<digit>(magnitude);
+      if constexpr (sizeof(U) > sizeof(digit)) {
+        magnitude >>= digit_bits;
+      }
+    }
+    return with_(ctx_().pow(base.value_, digits));
+  }
+
+  // Conversions
+  /// Return the least nonnegative integer in the residue class.
+  bi_t value() const { return ctx_().decode(value_); }
+  /// Return the stored residue, in Montgomery form.
+  const limbs& montgomery_value() const noexcept { return value_; }
+
+  friend std::ostream& operator<<(std::ostream& os, const Derived& x) {
+    return os << x.value();
+  }
+
+ protected:
+  limbs value_{};
+
+ private:
+  const montgomery<N>& ctx_() const noexcept { return self_().context(); }
+  const Derived& self_() const noexcept {
+    return static_cast<const Derived&>(*this);
+  }
+  Derived& self_() noexcept { return static_cast<Derived&>(*this); }
+  Derived with_(const limbs& value) const noexcept {
+    Derived r = self_();
+    r.value_ = value;
+    return r;
+  }
+};
+/// @endcond
+
+/**
+ *  @class modint
+ *  @headerfile "bi_modint.hpp"
+ *  @brief Integers modulo the compile-time constant `Modulus`.
+ *
+ *  `Modulus` is a positive odd integer, e.g. `modint<998244353>`, or, for
+ *  moduli wider than an integer type, a `std::array<digit, N>` of its digits,
+ *  least significant first. Values are stored in Montgomery form in as many
+ *  digits as the modulus needs, and `+`, `-`, `*`, `/`, `pow()` and `inv()`
+ *  keep them reduced without allocating (see `montgomery`). The constants of
+ *  Montgomery arithmetic are computed at compile time.
+ *
+ *  Example: `modint<7> x = 3; x.inv() == 5; (x / 2).value() == 5`.
+ *
+ *  @throw bi::division_by_zero Throws on division by, or inversion of, a value
+ *  that is not invertible.
+ */
+template <auto Modulus>
+class modint : public modint_base<modint<Modulus>,
+                                  modint_detail::size_of<Modulus>> {
+ public:
+  static constexpr size_t size = modint_detail::size_of<Modulus>;
+  using context_type = montgomery<size>;
+
+  constexpr modint() noexcept = default;
+  template <std::integral T>
+  modint(T value) {  // NOLINT(runtime/explicit)
+    this->value_ = context_.encode(value);
+  }
+  explicit modint(const bi_t& value) { this->value_ = context_.encode(value); }
+
+  static constexpr const context_type& context() noexcept { return context_; }
+  static bi_t modulus() { return context_.modulus_bi(); }
+
+ private:
+  static_assert(modint_detail::digits_of<Modulus>()[0] % 2 != 0,
+                "Modulus must be odd.");
+  static constexpr context_type context_{modint_detail::digits_of<Modulus>()};
+};
+
+/**
+ *  @class dyn_modint
+ *  @headerfile "bi_modint.hpp"
+ *  @brief Integers modulo an odd modulus of at most `N` digits that is chosen
+ *  at run time.
+ *
+ *  The modulus and the constants of Montgomery arithmetic are held by a
+ *  `dyn_modint<N>::context_type`, which must outlive the values that refer to
+ *  it; operands of a binary operation must refer to the same context. Values
+ *  are stored in `N` digits, and `+`, `-`, `*`, `/`, `pow()` and `inv()` keep
+ *  them reduced without allocating.
+ *
+ *  Example: `dyn_modint<2>::context_type ctx(p); dyn_modint<2> x(ctx, 3);`
+ *
+ *  @throw bi::division_by_zero Throws on division by, or inversion of, a value
+ *  that is not invertible.
+ */
+template <size_t N = 1>
+class dyn_modint : public modint_base<dyn_modint<N>, N> {
+ public:
+  using context_type = montgomery<N>;
+
+  /// Construct the zero of `context`.
+  explicit dyn_modint(const context_type& context) noexcept
+      : context_(&context) {}
+  template <std::integral T>
+  dyn_modint(const context_type& context, T value) : context_(&context) {
+    this->value_ = context.encode(value);
+  }
+  dyn_modint(const context_type& context, const bi_t& value)
+      : context_(&context) {
+    this->value_ = context.encode(value);
+  }
+
+  const context_type& context() const noexcept { return *context_; }
+  bi_t modulus() const { return context_->modulus_bi(); }
+
+ private:
+  const context_type* context_;
+};
+
+}  // namespace bi
+
+#endif  // BI_INCLUDE_BI_MODINT_HPP_
@@ -0,0 +1,75 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef BI_INCLUDE_BI_RATIONAL_HPP_
+#define BI_INCLUDE_BI_RATIONAL_HPP_
+
+#include <compare>
+#include <iostream>
+#include <string>
+
+#include "bi.hpp"
+
+namespace bi {
+
+class BI_API rational {
+ public:
+  // Constructors
+  rational();
+  rational(const bi_t& num);  // NOLINT(runtime/explicit)
+  rational(const bi_t& num, const bi_t& den);
+  template <std::integral T>
+  rational(T value)  // NOLINT(runtime/explicit)
+      : num_(value), den_(1), normalized_(true) {}
+  explicit rational(double);
+  explicit rational(const std::string&);
+
+  // Accessors
+  const bi_t& numerator() const noexcept;
+  const bi_t& denominator() const noexcept;
+  bool normalized() const noexcept;
+  rational& normalize();
+
+  // Unary operators
+  rational operator+() const;
+  rational operator-() const;
+
+  // Arithmetic operators
+  rational operator+(const rational&) const;
+  rational operator-(const rational&) const;
+  rational operator*(const rational&) const;
+  rational operator/(const rational&) const;
+  rational& operator+=(const rational&);
+  rational& operator-=(const rational&);
+  rational& operator*=(const rational&);
+  rational& operator/=(const rational&);
+
+  // Comparisons
+  std::strong_ordering operator<=>(const rational&) const;
+  bool operator==(const rational&) const;
+
+  // Conversion operators
+  explicit operator double() const;
+
+  // Other
+  void swap(rational&) noexcept;
+  std::string to_string() const;
+  int sign() const noexcept;
+
+ private:
+  bi_t num_;
+  bi_t den_;
+  bool normalized_;
+
+  rational& add_(const rational& other, bool subtract);
+};
+
+BI_API std::ostream& operator<<(std::ostream&, const rational&);
+
+BI_API void swap(rational& a, rational& b) noexcept;
+
+}  // namespace bi
+
+#endif  // BI_INCLUDE_BI_RATIONAL_HPP_
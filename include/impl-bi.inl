@@ -8,10 +8,107 @@ SPDX-License-Identifier: Apache-2.0
 
 #include "bi.hpp"
 
+#include <concepts>
+#include <type_traits>
 #include <utility>
 
 namespace bi {
 
+/**
+ *  @name Increment and decrement
+ *  @details The common case, in which the least significant digit absorbs the
+ *  change without a carry or borrow and the sign does not change, is handled
+ *  inline.
+ */
+///@{
+
+inline bi_t& bi_t::operator++() {
+  if (!add_digit_(1, false)) {
+    increment_();
+  }
+  return *this;
+}
+
+inline bi_t& bi_t::operator--() {
+  if (!add_digit_(1, true)) {
+    decrement_();
+  }
+  return *this;
+}
+
+///@}
+
+/**
+ *  @name Additive operators with integral types
+ *  @details If `value` fits in a digit, the common case is handled inline as
+ *  for increment and decrement. Otherwise, these are the same as adding or
+ *  subtracting `bi_t(value)`.
+ */
+///@{
+
+template <std::integral T>
+inline bi_t& bi_t::operator+=(T value) {
+  if constexpr (sizeof(T) <= sizeof(digit)) {
+    digit magnitude = static_cast<digit>(value);
+    bool value_negative = false;
+    if constexpr (std::is_signed_v<T>) {
+      value_negative = value < 0;
+      magnitude = value_negative ? digit{0} - magnitude : magnitude;
+    }
+    if (add_digit_(magnitude, value_negative)) {
+      return *this;
+    }
+  }
+  return *this += bi_t(value);
+}
+
+template <std::integral T>
+inline bi_t& bi_t::operator-=(T value) {
+  if constexpr (sizeof(T) <= sizeof(digit)) {
+    digit magnitude = static_cast<digit>(value);
+    bool value_negative = false;
+    if constexpr (std::is_signed_v<T>) {
+      value_negative = value < 0;
+      magnitude = value_negative ? digit{0} - magnitude : magnitude;
+    }
+    if (add_digit_(magnitude, !value_negative)) {
+      return *this;
+    }
+  }
+  return *this -= bi_t(value);
+}
+
+///@}
+
+/**
+ *  Try to add the integer with magnitude `magnitude` and sign `negative` by
+ *  changing only the least significant digit. Return false, leaving this
+ *  integer unchanged, if that would carry, borrow, or change the sign.
+ */
+inline bool bi_t::add_digit_(digit magnitude, bool negative) noexcept {
+  if (vec_.size() == 0) {
+    return false;
+  }
+
+  digit& low = vec_[0];
+  if (negative == negative_) {
+    // Same signs: the magnitude grows
+    const digit sum = low + magnitude;
+    if (sum < low) {
+      return false;
+    }
+    low = sum;
+    return true;
+  }
+
+  // Opposite signs: the magnitude shrinks, and must stay nonzero
+  if (low > magnitude || (low == magnitude && vec_.size() > 1)) {
+    low -= magnitude;
+    return true;
+  }
+  return false;
+}
+
 /**
  *  @name Accessors for internal representation
  */
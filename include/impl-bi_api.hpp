@@ -0,0 +1,19 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef BI_INCLUDE_IMPL_BI_API_HPP_
+#define BI_INCLUDE_IMPL_BI_API_HPP_
+
+#if defined(_WIN32)
+#if defined(BI_API_EXPORTS)
+#define BI_API __declspec(dllexport)
+#else
+#define BI_API __declspec(dllimport)
+#endif
+#else
+#define BI_API
+#endif
+
+#endif  // BI_INCLUDE_IMPL_BI_API_HPP_
@@ -10,15 +10,58 @@ SPDX-License-Identifier: Apache-2.0
 #include <cassert>
 #include <climits>
 #include <concepts>
+#include <cstddef>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <new>
 #include <utility>
 
 #include "bi_exceptions.hpp"
+#include "impl-bi_api.hpp"
 
 namespace bi {
 
+namespace memory {
+
+// Storage of digit arrays, under the policy of bi_memory.hpp. Defined in
+// bi_memory.cpp.
+BI_API void* allocate(size_t bytes, bool& mapped);
+BI_API void unmap(void* p, size_t bytes) noexcept;
+
+/**
+ *  Deleter of a digit array. Records the capacity of the array and whether it
+ *  was mapped with huge pages or allocated with `operator new`, so that the
+ *  policy may change while arrays allocated under another one are alive.
+ */
+template <std::unsigned_integral digit>
+class digit_deleter {
+ public:
+  digit_deleter() noexcept = default;
+  digit_deleter(size_t capacity, bool mapped) noexcept
+      : bits_(capacity | (mapped ? mapped_bit : 0)) {}
+
+  size_t capacity() const noexcept { return bits_ & ~mapped_bit; }
+  bool mapped() const noexcept { return (bits_ & mapped_bit) != 0; }
+
+  void operator()(digit* p) const noexcept {
+    if (mapped()) {
+      unmap(p, capacity() * sizeof(digit));
+    } else {
+      ::operator delete(p);
+    }
+  }
+
+ private:
+  // Capacities are at most SIZE_MAX / sizeof(digit), so the top bit is free
+  static constexpr size_t mapped_bit =
+      ~(std::numeric_limits<size_t>::max() >> 1);
+
+  size_t bits_{0};
+};
+
+}  // namespace memory
+
 template <std::unsigned_integral digit, std::unsigned_integral bitcount>
 class digit_vector {
  public:
@@ -37,18 +80,15 @@ class digit_vector {
 
   // Copy constructor
   digit_vector(const digit_vector& other)
-      // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
-      : digits_(std::make_unique_for_overwrite<digit[]>(other.capacity_)),
-        size_(other.size_), capacity_(other.capacity_) {
+      : digits_(allocate(other.capacity())), size_(other.size_) {
     std::copy(other.digits_.get(), other.digits_.get() + size_, digits_.get());
   }
 
   // Move constructor
   digit_vector(digit_vector&& other) noexcept
-      : digits_(std::move(other.digits_)), size_(other.size_),
-        capacity_(other.capacity_) {
+      : digits_(std::move(other.digits_)), size_(other.size_) {
+    other.digits_.get_deleter() = deleter();
     other.size_ = 0;
-    other.capacity_ = 0;
   }
 
   // Copy assignment
@@ -57,7 +97,6 @@ class digit_vector {
       digit_vector temp(other);
       std::swap(digits_, temp.digits_);
       std::swap(size_, temp.size_);
-      std::swap(capacity_, temp.capacity_);
     }
     return *this;
   }
@@ -67,9 +106,8 @@ class digit_vector {
     if (this != &other) {
       digits_ = std::move(other.digits_);
       size_ = other.size_;
-      capacity_ = other.capacity_;
+      other.digits_.get_deleter() = deleter();
       other.size_ = 0;
-      other.capacity_ = 0;
     }
     return *this;
   }
@@ -77,15 +115,13 @@ class digit_vector {
   template <typename DigitIterator>
   digit_vector(DigitIterator first, DigitIterator last) {
     auto distance = std::distance(first, last);
-    // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
-    digits_ = std::make_unique_for_overwrite<digit[]>(distance);
+    digits_ = allocate(distance);
     std::copy(first, last, digits_.get());
     size_ = distance;
-    capacity_ = distance;
   }
 
   void resize(size_t new_size) {
-    if (new_size > capacity_) {
+    if (new_size > capacity()) {
       reserve(new_size);
     }
     size_ = new_size;
@@ -97,32 +133,30 @@ class digit_vector {
           "Requested capacity exceeds maximum allowable size.");
     }
 
-    if (new_capacity > capacity_) {
-      // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
-      auto new_digits = std::make_unique_for_overwrite<digit[]>(new_capacity);
+    if (new_capacity > capacity()) {
+      auto new_digits = allocate(new_capacity);
       std::copy(digits_.get(), digits_.get() + size_, new_digits.get());
       digits_ = std::move(new_digits);
-      capacity_ = new_capacity;
     }
   }
 
   void push_back(const digit& value) {
-    if (size_ >= capacity_) {
-      reserve(capacity_ + 1);
+    if (size_ >= capacity()) {
+      reserve(capacity() + 1);
     }
     digits_[size_] = value;
     ++size_;
   }
 
   void resize_unsafe(size_t new_size) {
-    assert(new_size <= capacity_);
+    assert(new_size <= capacity());
     size_ = new_size;
   }
 
   digit* data() noexcept { return digits_.get(); }
   const digit* data() const noexcept { return digits_.get(); }
   size_t size() const noexcept { return size_; }
-  size_t capacity() const noexcept { return capacity_; }
+  size_t capacity() const noexcept { return digits_.get_deleter().capacity(); }
 
   static constexpr size_t max_size() noexcept {
     constexpr size_t a = std::numeric_limits<size_t>::max() / sizeof(digit);
@@ -146,10 +180,20 @@ class digit_vector {
   const_riterator rend() const noexcept { return const_riterator(begin()); }
 
  private:
+  using deleter = memory::digit_deleter<digit>;
   // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
-  std::unique_ptr<digit[]> digits_;
+  using storage = std::unique_ptr<digit[], deleter>;
+
+  // The capacity is kept by the deleter
+  storage digits_;
   size_t size_{0};
-  size_t capacity_{0};
+
+  // Return uninitialized storage for `capacity` digits
+  static storage allocate(size_t capacity) {
+    bool mapped = false;
+    void* p = memory::allocate(capacity * sizeof(digit), mapped);
+    return storage(static_cast<digit*>(p), deleter(capacity, mapped));
+  }
 };
 
 };  // namespace bi
@@ -0,0 +1,176 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef BI_INCLUDE_IMPL_BI_FAST_INL_
+#define BI_INCLUDE_IMPL_BI_FAST_INL_
+
+#include "bi.hpp"
+
+#include <compare>
+#include <cstdint>
+
+namespace bi {
+
+/**
+ *  Set this integer to `a + b`, or to `a - b` if `subtract` is true, and
+ *  return true, if neither operand has more than one digit. Otherwise, return
+ *  false. This integer may be `a` or `b`.
+ */
+inline bool bi_t::add_small_(const bi_t& a, const bi_t& b, bool subtract) {
+  if (a.vec_.size() > 1 || b.vec_.size() > 1) {
+    return false;
+  }
+
+  const digit x = a.vec_.size() != 0 ? a.vec_[0] : 0;
+  const digit y = b.vec_.size() != 0 ? b.vec_[0] : 0;
+  const bool x_negative = a.negative_;
+  const bool y_negative = (b.negative_ != subtract) && y != 0;
+
+  if (x_negative == y_negative) {
+    const digit low = x + y;
+    const bool carry = low < x;
+    vec_.resize(carry ? 2 : (low != 0 ? 1 : 0));
+    if (carry) {
+      vec_[1] = 1;
+    }
+    if (vec_.size() != 0) {
+      vec_[0] = low;
+    }
+    negative_ = x_negative && vec_.size() != 0;
+    return true;
+  }
+
+  // Opposite signs: the result has the sign of the larger magnitude
+  const digit magnitude = x >= y ? x - y : y - x;
+  const bool magnitude_negative = x >= y ? x_negative : y_negative;
+  vec_.resize(magnitude != 0 ? 1 : 0);
+  if (magnitude != 0) {
+    vec_[0] = magnitude;
+  }
+  negative_ = magnitude_negative && magnitude != 0;
+  return true;
+}
+
+/**
+ *  Set this integer to `a * b` and return true, if neither operand has more
+ *  than one digit. Otherwise, return false. This integer may be `a` or `b`.
+ */
+inline bool bi_t::mul_small_(const bi_t& a, const bi_t& b) {
+  if (a.vec_.size() > 1 || b.vec_.size() > 1) {
+    return false;
+  }
+  if (a.vec_.size() == 0 || b.vec_.size() == 0) {
+    vec_.resize(0);
+    negative_ = false;
+    return true;
+  }
+
+#if defined(BI_DIGIT_64_BIT)
+  __extension__ typedef unsigned __int128 wide;  // NOLINT
+#else
+  using wide = uint64_t;
+#endif
+  const wide product = static_cast<wide>(a.vec_[0]) * b.vec_[0];
+  const auto high = static_cast<digit>(product >> (sizeof(digit) * CHAR_BIT));
+  const bool product_negative = a.negative_ != b.negative_;
+
+  vec_.resize(high != 0 ? 2 : 1);
+  vec_[0] = static_cast<digit>(product);
+  if (high != 0) {
+    vec_[1] = high;
+  }
+  negative_ = product_negative;
+  return true;
+}
+
+#if defined(BI_INLINE_FAST_PATHS)
+
+/**
+ *  @name Inline fast paths
+ *  @details With `BI_INLINE_FAST_PATHS` defined, these operators are defined
+ *  here instead of in the library, so that the compiler can inline them into
+ *  user code. Operands of at most one digit are handled inline, with no
+ *  function call and no sign dispatch; compound assignments to such operands
+ *  then reuse the storage of their left operand. Larger operands take the
+ *  general path of the library.
+ */
+///@{
+
+inline bi_t bi_t::operator+(const bi_t& other) const {
+  bi_t ret;
+  if (!ret.add_small_(*this, other, false)) {
+    add_general_(ret, *this, other);
+  }
+  return ret;
+}
+
+inline bi_t bi_t::operator-(const bi_t& other) const {
+  bi_t ret;
+  if (!ret.add_small_(*this, other, true)) {
+    sub_general_(ret, *this, other);
+  }
+  return ret;
+}
+
+inline bi_t& bi_t::operator+=(const bi_t& other) {
+  if (!add_small_(*this, other, false)) {
+    add_general_(*this, *this, other);
+  }
+  return *this;
+}
+
+inline bi_t& bi_t::operator-=(const bi_t& other) {
+  if (!add_small_(*this, other, true)) {
+    sub_general_(*this, *this, other);
+  }
+  return *this;
+}
+
+inline bi_t bi_t::operator*(const bi_t& other) const {
+  bi_t ret;
+  if (!ret.mul_small_(*this, other)) {
+    mul_general_(ret, *this, other);
+  }
+  return ret;
+}
+
+inline bi_t& bi_t::operator*=(const bi_t& other) {
+  if (!mul_small_(*this, other)) {
+    mul_general_(*this, *this, other);
+  }
+  return *this;
+}
+
+inline std::strong_ordering bi_t::operator<=>(
+    const bi_t& other) const noexcept {
+  if (negative_ != other.negative_) {
+    return negative_ ? std::strong_ordering::less
+                     : std::strong_ordering::greater;
+  }
+  if (vec_.size() <= 1 && other.vec_.size() <= 1) {
+    const digit x = vec_.size() != 0 ? vec_[0] : 0;
+    const digit y = other.vec_.size() != 0 ? other.vec_[0] : 0;
+    return negative_ ? y <=> x : x <=> y;
+  }
+  return cmp_general_(*this, other) <=> 0;
+}
+
+inline bool bi_t::operator==(const bi_t& other) const noexcept {
+  if (negative_ != other.negative_ || vec_.size() != other.vec_.size()) {
+    return false;
+  }
+  if (vec_.size() <= 1) {
+    return vec_.size() == 0 || vec_[0] == other.vec_[0];
+  }
+  return cmp_general_(*this, other) == 0;
+}
+
+///@}
+
+#endif  // BI_INLINE_FAST_PATHS
+
+}  // namespace bi
+
+#endif  // BI_INCLUDE_IMPL_BI_FAST_INL_
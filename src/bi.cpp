@@ -6,9 +6,11 @@ SPDX-License-Identifier: Apache-2.0
 #include "bi.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <compare>
 #include <iostream>
 #include <limits>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <version>
@@ -71,6 +73,45 @@ namespace bi {
  *  constraints determine `max_size()` for the internal digit vector. An
  *  operation that expects a result to exceed `max_size()` throws
  *  `bi::overflow_error`.
+ *
+ *  ## Thread safety
+ *
+ *  `bi_t` gives the guarantees of the standard library types:
+ *  - Any number of threads may concurrently call `const` member functions of
+ *    the same integer, or pass it by `const` reference to functions of this
+ *    library.
+ *  - A thread that modifies an integer needs exclusive access to it.
+ *  - Operations on distinct integers need no synchronization.
+ *
+ *  The library's internal state keeps these guarantees. The random number
+ *  generator and the caches of small powers of ten and of CRT contexts are
+ *  `thread_local`. The process-wide cache of powers of the bases 2 to 36,
+ *  which string conversions and `pow()` share, takes no lock to read a cached
+ *  power; only computing a missing power, or evicting one, takes a lock.
+ *  Integers returned by `intern()` are immutable.
+ *
+ *  Multiplications of integers of thousands of digits, and their conversions
+ *  to strings, split their work over threads of their own, one group of
+ *  threads per NUMA node when the library is built with libnuma. Such work
+ *  started from one of these threads, or from another parallel operation of
+ *  the library, runs serially.
+ *
+ *  The test target `bi_stress_test` runs the operations of the library from
+ *  many threads, and is meant to be built with `-DBI_SANITIZE_THREAD=ON`.
+ */
+
+/**
+ *  @enum rounding
+ *  @brief Rounding modes for operations whose exact result is not
+ *  representable.
+ *
+ *  - `half_even`: round to nearest, ties to the even neighbour.
+ *  - `half_away_from_zero`: round to nearest, ties away from zero.
+ *  - `half_toward_zero`: round to nearest, ties toward zero.
+ *  - `toward_zero`: truncate.
+ *  - `away_from_zero`: round away from zero.
+ *  - `floor`: round toward negative infinity.
+ *  - `ceil`: round toward positive infinity.
  */
 
 /**
@@ -150,7 +191,17 @@ bi_t::bi_t(const char* s, int base) {
   h_::init_string(*this, std::string(s), base);
 }
 
-bi_t::bi_t(double d) { h_::assign_from_double(*this, d); }
+/**
+ *  @brief Constructor for `double`. The value is truncated toward zero.
+ *  @throw bi::from_float Throws if `d` is NaN or infinite.
+ */
+bi_t::bi_t(double d) { h_::assign_from_floating(*this, d); }
+
+/**
+ *  @brief Constructor for `long double`. The value is truncated toward zero.
+ *  @throw bi::from_float Throws if `d` is NaN or infinite.
+ */
+bi_t::bi_t(long double d) { h_::assign_from_floating(*this, d); }
 
 // NOLINTEND(cppcoreguidelines-pro-type-member-init)
 
@@ -238,7 +289,12 @@ bi_t& bi_t::operator=(const char* s) {
 }
 
 bi_t& bi_t::operator=(double d) {
-  h_::assign_from_double(*this, d);
+  h_::assign_from_floating(*this, d);
+  return *this;
+}
+
+bi_t& bi_t::operator=(long double d) {
+  h_::assign_from_floating(*this, d);
   return *this;
 }
 
@@ -266,8 +322,20 @@ bi_t bi_t::operator-() const {
  */
 ///@{
 
-bi_t& bi_t::operator++() {
-  // return *this += bi_t{1};
+bi_t bi_t::operator++(int) {
+  bi_t temp{*this};
+  ++(*this);
+  return temp;
+}
+
+bi_t bi_t::operator--(int) {
+  bi_t temp{*this};
+  --(*this);
+  return temp;
+}
+
+/// Add one, in the cases that `operator++()` does not handle inline.
+void bi_t::increment_() {
   if (!negative()) {
     h_::increment_abs(*this);
   } else {
@@ -276,80 +344,72 @@ bi_t& bi_t::operator++() {
       negative_ = false;
     }
   }
-  return *this;
 }
 
-bi_t bi_t::operator++(int) {
-  bi_t temp{*this};
-  ++(*this);
-  return temp;
-}
-
-bi_t& bi_t::operator--() {
-  // return *this -= bi_t{1};
+/// Subtract one, in the cases that `operator--()` does not handle inline.
+void bi_t::decrement_() {
   if (!negative()) {
     h_::decrement_abs(*this);
   } else {
     h_::increment_abs(*this);
   }
-  return *this;
-}
-
-bi_t bi_t::operator--(int) {
-  bi_t temp{*this};
-  --(*this);
-  return temp;
 }
 
 ///@}
 
 /**
  *  @name Multiplicative operators
+ *  @details Division works in the storage of its result: `/=` and `%=` only
+ *  allocate if this integer has no room for one more digit, or to hold a
+ *  normalized copy of a long divisor. Only the requested half of the division
+ *  is formed.
  *  @throw bi::division_by_zero Throws if a division by zero attempt is
  *  detected.
  */
 ///@{
 
+#if !defined(BI_INLINE_FAST_PATHS)
 /// @complexity \f$ O(n^{\log_{2}(3)}) \approx O(n^{1.58}) \f$
 bi_t bi_t::operator*(const bi_t& other) const {
   bi_t ret;
   h_::mul(ret, *this, other);
   return ret;
 }
+#endif
 
 /// @complexity \f$ O(m \cdot n) \f$
 bi_t bi_t::operator/(const bi_t& other) const {
-  bi_t quot, rem;
-  h_::divide(quot, rem, *this, other);
+  bi_t quot;
+  h_::assign_reserve(quot, *this, size() + 1);
+  h_::div_inplace(quot, other, false);
   return quot;
 }
 
 /// @complexity \f$ O(m \cdot n) \f$
 bi_t bi_t::operator%(const bi_t& other) const {
-  bi_t quot, rem;
-  h_::divide(quot, rem, *this, other);
+  bi_t rem;
+  h_::assign_reserve(rem, *this, size() + 1);
+  h_::div_inplace(rem, other, true);
   return rem;
 }
 
+#if !defined(BI_INLINE_FAST_PATHS)
 /// @complexity \f$ O(n^{\log_{2}(3)}) \approx O(n^{1.58}) \f$
 bi_t& bi_t::operator*=(const bi_t& other) {
   h_::mul(*this, *this, other);
   return *this;
 }
+#endif
 
 /// @complexity \f$ O(m \cdot n) \f$
 bi_t& bi_t::operator/=(const bi_t& other) {
-  bi_t quot, rem;
-  h_::divide(quot, rem, *this, other);
-  swap(quot);
+  h_::div_inplace(*this, other, false);
   return *this;
 }
 
 /// @complexity \f$ O(m \cdot n) \f$
 bi_t& bi_t::operator%=(const bi_t& other) {
-  bi_t quot, rem;
-  h_::divide(quot, rem, *this, other);
-  swap(rem);
+  h_::div_inplace(*this, other, true);
   return *this;
 }
 
@@ -369,6 +429,92 @@ std::pair<bi_t, bi_t> bi_t::div(const bi_t& other) const {
   return std::make_pair(std::move(quot), std::move(rem));
 }
 
+/**
+ *  @brief Return the least nonnegative residue of this integer modulo `m`,
+ *  i.e. the remainder of Euclidean division by `m`.
+ *  @details Only the remainder is computed, one digit at a time, with a
+ *  precomputed reciprocal of `m`. If `m` is a power of two, only the least
+ *  significant digit is read.
+ *  @complexity O(n)
+ */
+digit bi_t::mod_ui(digit m) const {
+  if (m == 0) {
+    throw division_by_zero("Division by zero attempt.");
+  }
+
+  digit r = 0;
+  if (size() == 0) {
+    return 0;
+  } else if (std::has_single_bit(m)) {
+    r = vec_[0] & (m - 1);
+  } else if (size() == 1) {
+    r = vec_[0] % m;
+  } else {
+    r = h_::rem_algo_digit(*this, make_reciprocal(m));
+  }
+
+  return negative_ && r != 0 ? m - r : r;
+}
+
+/**
+ *  @brief Set `residues[i]` to `mod_ui(moduli[i])` for each `i`.
+ *  @details Consecutive moduli are grouped so that the product of each group
+ *  fits in a digit. This integer is then reduced once per group, by the
+ *  product of its moduli, and the residue modulo each modulus of the group is
+ *  found from that single-digit remainder. For moduli of up to 8 bits and
+ *  32-bit digits, this reads this integer once per four moduli.
+ *  @throw std::invalid_argument Throws if the spans have different sizes.
+ *  @complexity O(n * k / g), for `k` moduli in groups of `g`.
+ */
+void bi_t::mod_ui(std::span<const digit> moduli,
+                  std::span<digit> residues) const {
+  if (moduli.size() != residues.size()) {
+    throw std::invalid_argument("Moduli and residues differ in size.");
+  }
+  if (std::find(moduli.begin(), moduli.end(), 0) != moduli.end()) {
+    throw division_by_zero("Division by zero attempt.");
+  }
+
+  size_t begin = 0;
+  while (begin < moduli.size()) {
+    ddigit product = moduli[begin];
+    size_t end = begin + 1;
+    while (end < moduli.size() && product * moduli[end] <= bi_dmax) {
+      product *= moduli[end++];
+    }
+
+    const digit r = mod_ui(static_cast<digit>(product));
+    for (size_t i = begin; i < end; ++i) {
+      residues[i] = r % moduli[i];
+    }
+    begin = end;
+  }
+}
+
+/**
+ *  @brief Return `true` if this integer is a multiple of `m`, `false`
+ *  otherwise. Zero is the only multiple of zero.
+ *  @details O(1) if `m` is a power of two, comparing the number of trailing
+ *  zero bits of the least significant digit; otherwise, only the remainder is
+ *  computed.
+ *  @complexity O(n)
+ */
+bool bi_t::divisible_by(digit m) const noexcept {
+  if (size() == 0) {
+    return true;
+  }
+  if (m == 0) {
+    return false;
+  }
+  if (std::has_single_bit(m)) {
+    return vec_[0] == 0 || std::countr_zero(vec_[0]) >= std::countr_zero(m);
+  }
+  if (size() == 1) {
+    return vec_[0] % m == 0;
+  }
+  return h_::rem_algo_digit(*this, make_reciprocal(m)) == 0;
+}
+
 ///@}
 
 /**
@@ -376,6 +522,7 @@ std::pair<bi_t, bi_t> bi_t::div(const bi_t& other) const {
  */
 ///@{
 
+#if !defined(BI_INLINE_FAST_PATHS)
 /// @complexity \f$ O(n) \f$
 bi_t bi_t::operator+(const bi_t& other) const {
   bi_t ret;
@@ -401,6 +548,7 @@ bi_t& bi_t::operator-=(const bi_t& other) {
   h_::sub(*this, *this, other);
   return *this;
 }
+#endif
 
 ///@}
 
@@ -467,6 +615,7 @@ bi_t& bi_t::operator>>=(bi_bitcount_t shift) {
  */
 ///@{
 
+#if !defined(BI_INLINE_FAST_PATHS)
 std::strong_ordering bi_t::operator<=>(const bi_t& other) const noexcept {
   return h_::cmp(*this, other) <=> 0;
 }
@@ -474,9 +623,30 @@ std::strong_ordering bi_t::operator<=>(const bi_t& other) const noexcept {
 bool bi_t::operator==(const bi_t& other) const noexcept {
   return h_::cmp(*this, other) == 0;
 }
+#endif
 
 ///@}
 
+/// @cond
+// General cases of the operators that impl-bi_fast.inl may define inline
+
+void bi_t::add_general_(bi_t& result, const bi_t& a, const bi_t& b) {
+  h_::add(result, a, b);
+}
+
+void bi_t::sub_general_(bi_t& result, const bi_t& a, const bi_t& b) {
+  h_::sub(result, a, b);
+}
+
+void bi_t::mul_general_(bi_t& result, const bi_t& a, const bi_t& b) {
+  h_::mul(result, a, b);
+}
+
+int bi_t::cmp_general_(const bi_t& a, const bi_t& b) noexcept {
+  return h_::cmp(a, b);
+}
+/// @endcond
+
 /**
  *  @name Comparisons with integral types
  *  @brief Efficient comparison between `bi_t`s and any standard integral type
@@ -711,23 +881,43 @@ bi_t::operator T() const noexcept {
   return ret;
 }
 
-bi_t::operator double() const noexcept {
-  if (size() == 0) {
-    return 0.0;
-  }
+/**
+ *  @brief Return the integer rounded to the nearest `float`, ties to even.
+ *  Integers beyond the range of `float` give an infinity.
+ */
+bi_t::operator float() const noexcept { return to_float(); }
 
-  double result = 0.0;
+/**
+ *  @brief Return the integer rounded to the nearest `double`, ties to even.
+ *  Integers beyond the range of `double` give an infinity.
+ */
+bi_t::operator double() const noexcept { return to_double(); }
 
-  for (size_t i = size(); i-- > 0;) {
-    // First operand to addition same as `std::ldexp(result, bi_dbits)`
-    result = result * bi_base_dbl + static_cast<double>((*this)[i]);
-  }
+/**
+ *  @brief Return the integer rounded to the nearest `long double`, ties to
+ *  even.
+ */
+bi_t::operator long double() const noexcept { return to_long_double(); }
 
-  if (negative_) {
-    result = -result;
-  }
+/**
+ *  @brief Return the integer rounded to a `float` according to `mode`.
+ *  @details Reads only the leading digits and, if needed to decide the
+ *  rounding, whether any lower bit is set. An integer beyond the range of
+ *  `float` gives an infinity when rounding to nearest or away from zero, and
+ *  the largest finite `float` of its sign otherwise.
+ */
+float bi_t::to_float(rounding mode) const noexcept {
+  return h_::to_floating<float>(*this, mode);
+}
 
-  return result;
+/// @brief Return the integer rounded to a `double`, as `to_float()`.
+double bi_t::to_double(rounding mode) const noexcept {
+  return h_::to_floating<double>(*this, mode);
+}
+
+/// @brief Return the integer rounded to a `long double`, as `to_float()`.
+long double bi_t::to_long_double(rounding mode) const noexcept {
+  return h_::to_floating<long double>(*this, mode);
 }
 
 ///@}
@@ -780,6 +970,50 @@ bi_t& bi_t::set_bit(bi_bitcount_t i) {
   return *this;
 }
 
+/**
+ *  @brief Return `true` if the absolute value of this integer is a power of
+ *  two.
+ *  @details Only the leading digit is read unless it has a single bit set.
+ *  `*`, `/` and `%` use this to replace multiplication and division by
+ *  \f$ \pm 2^{k} \f$ with shifts and masks.
+ *  @complexity O(1) for most integers, O(n) otherwise.
+ */
+bool bi_t::is_pow2() const noexcept { return h_::is_pow2_abs(*this); }
+
+/**
+ *  @brief Replace this integer `x` with `x % 2^k`, i.e. keep the low `k` bits
+ *  of its absolute value and its sign, as `%` does.
+ *  @details Works in place, without allocating.
+ *  @complexity O(k / w), for `w`-bit digits.
+ */
+bi_t& bi_t::mod_pow2(bi_bitcount_t k) noexcept {
+  h_::low_bits(*this, *this, k);
+  return *this;
+}
+
+/**
+ *  @brief Replace this integer `x` with `x / 2^k`, rounded toward zero, as `/`
+ *  does.
+ *  @details Works in place, without allocating.
+ *  @complexity O(n - k / w), for `w`-bit digits.
+ */
+bi_t& bi_t::div_pow2_trunc(bi_bitcount_t k) noexcept {
+  h_::right_shift_trunc(*this, *this, k);
+  return *this;
+}
+
+/**
+ *  @brief Replace this integer `x` with `x / 2^k`, rounded toward negative
+ *  infinity, i.e. `x >>= k`.
+ *  @details Works in place. Rounding a negative quotient down stays within the
+ *  storage this integer already has.
+ *  @complexity O(n - k / w), for `w`-bit digits.
+ */
+bi_t& bi_t::div_pow2_floor(bi_bitcount_t k) {
+  h_::right_shift(*this, *this, k);
+  return *this;
+}
+
 ///@}
 
 /**
@@ -893,9 +1127,7 @@ void bi_t::print_internal(std::ostream& os) const noexcept {
  *  @endcode
  */
 std::string bi_t::to_string(int base) const {
-  // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
-  static constexpr auto base_digits = "0123456789abcdefghijklmnopqrstuvwxyz";
-
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
   if (base <= 1 || base > 36) {
     throw std::invalid_argument("base argument must be in [2, 36]");
   }
@@ -904,38 +1136,16 @@ std::string bi_t::to_string(int base) const {
     return "0";
   }
 
-  bi_t copy = *this;
   std::string result;
   const size_t estimate = h_::base_length(*this, base);
   result.reserve(estimate + negative_);
-
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
-  const auto [max_batch_size, divisor] = base_mbs[base];
-
-  while (copy.size()) {
-    digit remainder = h_::div_algo_digit(copy, copy, divisor);
-
-    for (unsigned i = 0; i < max_batch_size; ++i) {
-      if (remainder == 0 && copy.size() == 0) {
-        break;
-      }
-
-      digit current_digit = remainder % base;
-      remainder /= base;
-
-      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-      result.push_back(base_digits[current_digit]);
-    }
-  }
-
   if (negative_) {
     result.push_back('-');
   }
 
-  std::reverse(result.begin(), result.end());
-
+  bi_t magnitude = abs(*this);
+  h_::format_digits(result, magnitude, base, 0);
   return result;
-  // NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
 }
 
 /**
@@ -1010,6 +1220,15 @@ bi_t bi_t::pow(const bi_t& base, bi_bitcount_t exp) {
     }
     throw overflow_error("");
   }
+  // Small bases use the process-wide cache of their powers base^{2^k}
+  if (base.size() == 1 && base[0] >= power_cache::min_base &&
+      base[0] <= power_cache::max_base) {
+    bi_t result = power_cache::pow(static_cast<int>(base[0]), exp);
+    if (base.negative_ && exp % 2 != 0) {
+      result.negate();
+    }
+    return result;
+  }
   return h_::expo_left_to_right(base, exp);
 }
 
@@ -1029,7 +1248,7 @@ bi_t bi_t::pow(const bi_t& base, const bi_t& exp) {
     }
     throw overflow_error("");
   }
-  return h_::expo_left_to_right(base, static_cast<bi_bitcount_t>(exp));
+  return pow(base, static_cast<bi_bitcount_t>(exp));
 }
 
 ///@}
@@ -1058,6 +1277,25 @@ std::ostream& operator<<(std::ostream& os, const bi_t& x) {
  */
 void swap(bi_t& a, bi_t& b) noexcept { a.swap(b); }
 
+/**
+ *  @brief Return a hash of the value of `x`, which `std::hash<bi_t>` uses.
+ *  @details Equal integers have equal hashes. Each digit is mixed in with a
+ *  multiply-xorshift step, so that integers that differ in any digit or in
+ *  sign are unlikely to collide.
+ *  @relates bi_t
+ *  @complexity O(n)
+ */
+size_t hash_value(const bi_t& x) noexcept {
+  constexpr uint64_t multiplier = 0x9e3779b97f4a7c15;
+  uint64_t h = x.negative() ? ~uint64_t{0} : 0;
+  for (const digit d : x.digits()) {
+    h = (h ^ d) * multiplier;
+    h ^= h >> 32;
+  }
+  h ^= x.size();
+  return static_cast<size_t>((h * multiplier) ^ (h >> 29));
+}
+
 /**
  *  @brief User-defined literal (UDL) operator for creating `bi_t` objects.
  *  @return `bi_t(s)`.
@@ -1085,6 +1323,250 @@ bi_t abs(const bi_t& value) {
   return value;
 }
 
+/**
+ *  @brief Return the greatest common divisor of `a` and `b`. The result is
+ *  always nonnegative, and `gcd(0, 0)` is `0`.
+ *  @details Uses Lehmer's algorithm, which replaces most of the
+ *  multiple-precision divisions of Euclid's algorithm with single-precision
+ *  steps on the leading digits of the operands.
+ *  @relates bi_t
+ */
+bi_t gcd(const bi_t& a, const bi_t& b) {
+  bi_t result;
+  h_::gcd(result, a, b);
+  return result;
+}
+
+/**
+ *  @brief Return the low `n` digits of `a * b`, i.e. `|a * b| mod (2 **
+ *  bi_dbits) ** n`, with the sign of `a * b`.
+ *  @details The result is exact. Only the partial products that contribute to
+ *  the low `n` digits are formed (a "short product"), which costs about half
+ *  of a full product for schoolbook-sized operands and about 80% of one for
+ *  Karatsuba-sized operands. Useful for Montgomery and Hensel reduction.
+ *  @relates bi_t
+ */
+bi_t mul_low(const bi_t& a, const bi_t& b, size_t n) {
+  bi_t result;
+  h_::mul_low(result, a, b, n);
+  return result;
+}
+
+/**
+ *  @brief Return an approximation `h` of the leading `n` digits of `a * b`,
+ *  with the sign of `a * b`.
+ *  @details Let `k = a.size() + b.size() - n`. Then `|h| <= floor(|a * b| / (2
+ *  ** bi_dbits) ** k) <= |h| + min(a.size(), b.size())`. The result is exact
+ *  if `n >= a.size() + b.size()`.
+ *
+ *  The partial products that only affect the low `k - 1` digits of the
+ *  product are skipped, which is about half of the work of a full product for
+ *  schoolbook-sized operands. Useful for Barrett reduction and Newton
+ *  iterations, which only need the leading digits of a product.
+ *  @relates bi_t
+ */
+bi_t mul_high(const bi_t& a, const bi_t& b, size_t n) {
+  bi_t result;
+  h_::mul_high(result, a, b, n);
+  return result;
+}
+
+/**
+ *  @brief Performs `acc += a * b`.
+ *  @details For operands below the Karatsuba threshold, the product is added
+ *  into `acc` as it is formed when the signs allow it, without creating a
+ *  temporary. Repeated calls on the same accumulator, as in dot products, then
+ *  only allocate when `acc` outgrows its capacity.
+ *  @relates bi_t
+ */
+void addmul(bi_t& acc, const bi_t& a, const bi_t& b) {
+  h_::addmul(acc, a, b, false);
+}
+
+/**
+ *  @brief Performs `acc -= a * b`, as `addmul()`.
+ *  @relates bi_t
+ */
+void submul(bi_t& acc, const bi_t& a, const bi_t& b) {
+  h_::addmul(acc, a, b, true);
+}
+
+/**
+ *  @brief Return the coefficients of the product of the polynomials with
+ *  coefficients `a` and `b`, lowest degree first. The product of two
+ *  nonempty polynomials has `a.size() + b.size() - 1` coefficients; if either
+ *  is empty, so is the product.
+ *  @details Uses Kronecker substitution: both polynomials are evaluated at a
+ *  power of two large enough to separate the coefficients of the product,
+ *  which is then found by a single multiplication of large integers.
+ *  Coefficients may be negative. If `a` and `b` are the same span, the
+ *  product is computed as a square.
+ *  @complexity \f$ O(N^{\log_{2}(3)}) \f$ for packed operands of \f$ N \f$
+ *  digits.
+ *  @relates bi_t
+ */
+std::vector<bi_t> poly_mul(std::span<const bi_t> a, std::span<const bi_t> b) {
+  std::vector<bi_t> result;
+  h_::poly_mul(result, a, b);
+  return result;
+}
+
+/**
+ *  @brief Return `a / d`, where `d` is known to divide `a`.
+ *  @details Computes the quotient from the least significant digits with a
+ *  2-adic inverse of the divisor (Jebelean's exact division), which costs one
+ *  multiplication per quotient digit and is typically several times faster
+ *  than `a / d`. The result is unspecified if `d` does not divide `a`.
+ *  @throw bi::division_by_zero Throws if `d` is zero.
+ *  @relates bi_t
+ */
+bi_t divexact(const bi_t& a, const bi_t& d) {
+  bi_t result;
+  h_::divexact(result, a, d);
+  return result;
+}
+
+/**
+ *  @name Floor, ceiling and Euclidean division
+ *  @brief Division with the quotient rounded toward negative infinity
+ *  (`floor`), toward positive infinity (`ceil`), or such that the remainder is
+ *  nonnegative (`euclid`). In each case, `a == q * b + r` with `|r| < |b|`.
+ *  The remainder has the sign of `b` for `floor`, the opposite sign for
+ *  `ceil`, and is nonnegative for `euclid`.
+ *  @details Each function does a single truncating division and then, if the
+ *  remainder is nonzero and the truncated result is on the wrong side,
+ *  adjusts the quotient by one and the remainder by `|b|` in place. The
+ *  `div_*` and `mod_euclid` functions do not form the other half of the
+ *  division.
+ *  @throw bi::division_by_zero Throws if `b` is zero.
+ *  @relates bi_t
+ */
+///@{
+
+bi_t div_floor(const bi_t& a, const bi_t& b) {
+  bi_t q;
+  h_::assign_reserve(q, a, a.size() + 1);
+  if (h_::div_inplace(q, b, false) && a.negative() != b.negative()) {
+    h_::quot_away_from_zero(q, true);
+  }
+  return q;
+}
+
+bi_t div_ceil(const bi_t& a, const bi_t& b) {
+  bi_t q;
+  h_::assign_reserve(q, a, a.size() + 1);
+  if (h_::div_inplace(q, b, false) && a.negative() == b.negative()) {
+    h_::quot_away_from_zero(q, false);
+  }
+  return q;
+}
+
+bi_t div_euclid(const bi_t& a, const bi_t& b) {
+  bi_t q;
+  h_::assign_reserve(q, a, a.size() + 1);
+  if (h_::div_inplace(q, b, false) && a.negative()) {
+    h_::quot_away_from_zero(q, !b.negative());
+  }
+  return q;
+}
+
+bi_t mod_euclid(const bi_t& a, const bi_t& b) {
+  bi_t r;
+  h_::assign_reserve(r, a, a.size() + 1);
+  h_::div_inplace(r, b, true);
+  if (r.negative()) {
+    h_::rem_complement(r, b, false);
+  }
+  return r;
+}
+
+std::pair<bi_t, bi_t> divmod_floor(const bi_t& a, const bi_t& b) {
+  bi_t q, r;
+  h_::divide(q, r, a, b);
+  if (r.size() != 0 && a.negative() != b.negative()) {
+    h_::quot_away_from_zero(q, true);
+    h_::rem_complement(r, b, b.negative());
+  }
+  return std::make_pair(std::move(q), std::move(r));
+}
+
+std::pair<bi_t, bi_t> divmod_ceil(const bi_t& a, const bi_t& b) {
+  bi_t q, r;
+  h_::divide(q, r, a, b);
+  if (r.size() != 0 && a.negative() == b.negative()) {
+    h_::quot_away_from_zero(q, false);
+    h_::rem_complement(r, b, !b.negative());
+  }
+  return std::make_pair(std::move(q), std::move(r));
+}
+
+std::pair<bi_t, bi_t> divmod_euclid(const bi_t& a, const bi_t& b) {
+  bi_t q, r;
+  h_::divide(q, r, a, b);
+  if (r.negative()) {
+    h_::quot_away_from_zero(q, !b.negative());
+    h_::rem_complement(r, b, false);
+  }
+  return std::make_pair(std::move(q), std::move(r));
+}
+
+///@}
+
+/**
+ *  @name Number theory
+ */
+///@{
+
+/**
+ *  @brief Return `base ** exp mod |m|`, in `[0, |m|)`.
+ *  @details Each step of the exponentiation reduces its product in place.
+ *  @throw bi::division_by_zero Throws if `m` is zero.
+ *  @throw std::invalid_argument Throws if `exp` is negative.
+ *  @relates bi_t
+ */
+bi_t powmod(const bi_t& base, const bi_t& exp, const bi_t& m) {
+  bi_t result;
+  h_::powmod(result, base, exp, m);
+  return result;
+}
+
+/**
+ *  @brief Return the Jacobi symbol `(a / n)`, which is -1, 0 or 1.
+ *  @details Tracks the sign from the low bits of the operands only: factors
+ *  of two are removed with a trailing zero count, and multiple-precision
+ *  operands are reduced as in Euclid's algorithm until `n` fits in a digit,
+ *  when a binary single-precision algorithm finishes.
+ *  @throw std::invalid_argument Throws if `n` is not odd and positive.
+ *  @relates bi_t
+ */
+int jacobi(const bi_t& a, const bi_t& n) { return h_::jacobi(a, n); }
+
+/**
+ *  @brief Return the Kronecker symbol `(a / n)`, the extension of the Jacobi
+ *  symbol to every integer `n`.
+ *  @relates bi_t
+ */
+int kronecker(const bi_t& a, const bi_t& n) { return h_::kronecker(a, n); }
+
+/**
+ *  @brief Return the smaller square root of `a` modulo the odd prime `p`, i.e.
+ *  the `x` in `[0, p / 2]` with `x * x == a (mod p)`.
+ *  @details Uses one exponentiation if `p = 3 (mod 4)`, Atkin's method if `p =
+ *  5 (mod 8)`, and Tonelli-Shanks otherwise. The result is unspecified if `p`
+ *  is not prime.
+ *  @throw std::invalid_argument Throws if `p` is not odd and positive, or if
+ *  `a` is not a square modulo `p`. Also throws, rather than searching forever,
+ *  if no quadratic non-residue modulo a composite `p` exists (e.g. `p = 9`).
+ *  @relates bi_t
+ */
+bi_t sqrtmod(const bi_t& a, const bi_t& p) {
+  bi_t result;
+  h_::sqrtmod(result, a, p);
+  return result;
+}
+
+///@}
+
 /// @cond
 BI_INST_TEMPLATE_FOR_INTEGRAL_TYPES(bi_t::bi_t, BI_EMPTY);
 BI_INST_TEMPLATE_FOR_INTEGRAL_TYPES(bi_t& bi_t::operator=, BI_EMPTY);
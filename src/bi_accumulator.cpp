@@ -0,0 +1,213 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#include "bi_accumulator.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "bi.inl"
+#include "constants.hpp"
+
+namespace bi {
+
+namespace {
+
+/**
+ *  Normalize the columns once this many additions and subtractions are
+ *  pending. A normalized column has magnitude below `bi_base`, and each
+ *  operation changes it by less than `bi_base`, so columns stay below
+ *  `2 ** (2 * bi_dbits - 1)` in magnitude, with room for the carries of
+ *  `value()`.
+ */
+constexpr size_t max_pending = (size_t{1} << (bi_dbits - 1)) - 2;
+
+/// Return column `i` of `columns`.
+sddigit load(const std::vector<digit>& columns, size_t i) noexcept {
+  const ddigit value =
+      (static_cast<ddigit>(columns[2 * i + 1]) << bi_dbits) | columns[2 * i];
+  return static_cast<sddigit>(value);
+}
+
+/// Set column `i` of `columns` to `value`.
+void store(std::vector<digit>& columns, size_t i, sddigit value) noexcept {
+  const auto bits = static_cast<ddigit>(value);
+  columns[2 * i] = static_cast<digit>(bits);
+  columns[2 * i + 1] = static_cast<digit>(bits >> bi_dbits);
+}
+
+}  // namespace
+
+/**
+ *  @class accumulator
+ *  @headerfile "bi_accumulator.hpp"
+ *  @brief Running sum of `bi_t` values, for adding up many integers.
+ *
+ *  `bi_t::operator+=` propagates carries through the whole sum, and may grow
+ *  the sum, on every call. An `accumulator` instead keeps its sum in a
+ *  *redundant* representation: a column of twice the width of a digit per
+ *  digit position, holding a signed value. Adding or subtracting an integer
+ *  only adds or subtracts its digits into the matching columns, which costs
+ *  \f$ O(n) \f$ for an \f$ n \f$-digit operand, however large the sum. The
+ *  extra width of the columns leaves room for about
+ *  \f$ 2^{\mathrm{bi\_dbits} - 1} \f$ operations, after which the columns
+ *  are normalized, i.e. the carries are propagated, once.
+ *
+ *  Reading the sum with `value()` propagates the carries into a `bi_t`.
+ *
+ *  @throw std::bad_alloc Throws in case of memory allocation failure.
+ */
+
+/**
+ *  @name Constructors
+ */
+///@{
+
+/// Default constructor. The sum is initialized to zero.
+accumulator::accumulator() : pending_(0) {}
+
+/// Construct an accumulator whose sum is initialized to `initial`.
+accumulator::accumulator(const bi_t& initial) : pending_(0) {
+  assign_(initial);
+}
+
+///@}
+
+/**
+ *  @name Arithmetic operators
+ *  @complexity \f$ O(n) \f$ for an \f$ n \f$-digit operand, amortized.
+ */
+///@{
+
+accumulator& accumulator::operator+=(const bi_t& x) {
+  add_(x, false);
+  return *this;
+}
+
+accumulator& accumulator::operator-=(const bi_t& x) {
+  add_(x, true);
+  return *this;
+}
+
+///@}
+
+/**
+ *  @name Accessors
+ */
+///@{
+
+/**
+ *  @brief Return the sum.
+ *  @complexity \f$ O(n) \f$ for \f$ n \f$ columns.
+ */
+bi_t accumulator::value() const {
+  const size_t n = columns_.size() / 2;
+  bi_t result;
+  result.vec_.resize(n + 2);
+
+  // Two's complement digits of the sum
+  sddigit carry = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const sddigit t = load(columns_, i) + carry;
+    result.vec_[i] = static_cast<digit>(t);
+    carry = t >> bi_dbits;  // Floor division
+  }
+  result.vec_[n] = static_cast<digit>(carry);
+  result.vec_[n + 1] = carry < 0 ? bi_dmax : 0;
+
+  result.negative_ = carry < 0;
+  if (result.negative_) {
+    bool increment = true;
+    for (size_t i = 0; i < n + 2; ++i) {
+      result.vec_[i] = ~result.vec_[i] + static_cast<digit>(increment);
+      increment = increment && result.vec_[i] == 0;
+    }
+  }
+  result.trim();
+  return result;
+}
+
+///@}
+
+/**
+ *  @name Other
+ */
+///@{
+
+/// Set the sum to zero. Keeps the storage of the columns.
+void accumulator::clear() noexcept {
+  columns_.clear();
+  pending_ = 0;
+}
+
+/**
+ *  @brief Swap the contents of this accumulator with `other`.
+ *  @complexity O(1)
+ */
+void accumulator::swap(accumulator& other) noexcept {
+  columns_.swap(other.columns_);
+  std::swap(pending_, other.pending_);
+}
+
+///@}
+
+/// Add `x` to the columns, or subtract it if `subtract` is true.
+void accumulator::add_(const bi_t& x, bool subtract) {
+  if (pending_ == max_pending) {
+    assign_(value());
+  }
+  ++pending_;
+
+  const size_t n = x.size();
+  if (columns_.size() < 2 * n) {
+    columns_.resize(2 * n, 0);
+  }
+
+  const std::span<const digit> digits = x.digits();
+  if (x.negative() != subtract) {
+    for (size_t i = 0; i < n; ++i) {
+      store(columns_, i, load(columns_, i) - digits[i]);
+    }
+  } else {
+    for (size_t i = 0; i < n; ++i) {
+      store(columns_, i, load(columns_, i) + digits[i]);
+    }
+  }
+}
+
+/// Set the columns to the normalized representation of `x`.
+void accumulator::assign_(const bi_t& x) {
+  columns_.assign(2 * x.size(), 0);
+  pending_ = 0;
+
+  const std::span<const digit> digits = x.digits();
+  for (size_t i = 0; i < digits.size(); ++i) {
+    const auto column = static_cast<sddigit>(digits[i]);
+    store(columns_, i, x.negative() ? -column : column);
+  }
+}
+
+/**
+ *  @brief Return the sum of `values`.
+ *  @details Adds the values with an `accumulator`, so that the cost is linear
+ *  in the total number of digits of the values.
+ *  @relates accumulator
+ */
+bi_t sum(std::span<const bi_t> values) {
+  accumulator acc;
+  for (const bi_t& x : values) {
+    acc += x;
+  }
+  return acc.value();
+}
+
+/**
+ *  @brief Swap the contents of `a` with `b`.
+ *  @relates accumulator
+ *  @complexity O(1)
+ */
+void swap(accumulator& a, accumulator& b) noexcept { a.swap(b); }
+
+}  // namespace bi
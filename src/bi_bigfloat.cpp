@@ -0,0 +1,700 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#include "bi_bigfloat.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "bi_exceptions.hpp"
+#include "constants.hpp"
+#include "rounding.hpp"
+
+namespace bi {
+
+namespace {
+
+// Exponents of canonical values are kept within [-max_exponent, max_exponent],
+// so that the sum or difference of two of them, plus bit lengths, cannot
+// overflow an int64_t
+constexpr int64_t max_exponent = int64_t{1} << 61;
+
+// Extra bits kept per operand by the short product in `mul()`
+constexpr bi_bitcount_t mul_guard_bits = 64;
+
+void check_precision(bi_bitcount_t precision) {
+  if (precision == 0) {
+    throw std::invalid_argument("Precision must be positive.");
+  }
+}
+
+/// Return the number of trailing zero bits of the nonzero `x`.
+bi_bitcount_t count_trailing_zeros(const bi_t& x) noexcept {
+  bi_bitcount_t count = 0;
+  for (const digit d : x.digits()) {
+    if (d != 0) {
+      return count + std::countr_zero(d);
+    }
+    count += bi_dbits;
+  }
+  return count;
+}
+
+/// Return `floor(sqrt(n))` for `n > 0` by Newton's method.
+bi_t isqrt(const bi_t& n) {
+  // Any starting point above sqrt(n) decreases monotonically to the result
+  bi_t x = bi_t{1} << ((n.bit_length() + 1) / 2);
+  while (true) {
+    bi_t y = (x + n / x) >> 1;
+    if (y >= x) {
+      return x;
+    }
+    x.swap(y);
+  }
+}
+
+}  // namespace
+
+/**
+ *  @class bigfloat
+ *  @headerfile "bi_bigfloat.hpp"
+ *  @brief Arbitrary-precision binary floating-point type built on `bi_t`.
+ *
+ *  An instance of `bigfloat` represents the number \f$ m \cdot 2^{e} \f$, where
+ *  the mantissa \f$ m \f$ is a `bi_t` with at most `precision()` bits and the
+ *  exponent \f$ e \f$ is an `int64_t` with \f$ |e| \le 2^{61} \f$. Nonzero
+ *  values are kept with an odd mantissa, so that each value has a unique
+ *  representation.
+ *
+ *  Every operation is correctly rounded: the result is the exact result
+ *  rounded to the requested precision according to a `rounding` mode. The
+ *  operators round to the larger precision of the operands with
+ *  `rounding::half_even`; the static functions take the precision and the mode
+ *  explicitly.
+ *
+ *  Operations only compute as many bits as the rounding requires:
+ *  - Addition of an operand that lies entirely below the rounding position of
+ *    the result replaces it by a sticky bit.
+ *  - Multiplication of long operands truncates them to slightly more than the
+ *    working precision and forms only the leading digits of their product
+ *    (`mul_high()`), falling back to the full product only if the error could
+ *    affect the rounding.
+ *  - Division and square root compute a quotient or root of two bits more than
+ *    the working precision, plus a sticky bit for the remainder.
+ *
+ *  @throw std::bad_alloc Throws in case of memory allocation failure.
+ *  @throw std::invalid_argument Throws if a precision of zero is requested, or
+ *  for the square root of a negative number.
+ *  @throw bi::overflow_error Throws if the exponent of a result is out of
+ *  range.
+ *  @throw bi::division_by_zero Throws if a division by zero attempt is
+ *  detected.
+ */
+
+/**
+ *  @name Constructors
+ */
+///@{
+
+/// Default constructor. The number is initialized to zero.
+bigfloat::bigfloat() : exp_(0), prec_(default_precision) {}
+
+/**
+ *  @brief Construct the number `mantissa * 2^{exponent}`, rounded to
+ *  `precision` bits according to `mode`.
+ */
+bigfloat::bigfloat(const bi_t& mantissa, int64_t exponent,
+                   bi_bitcount_t precision, rounding mode)
+    : exp_(0), prec_(precision) {
+  check_precision(precision);
+  // Bit lengths are far below max_exponent, so the result is out of range too
+  if (exponent > 2 * max_exponent || exponent < -2 * max_exponent) {
+    throw overflow_error("Exponent out of range.");
+  }
+  assign_rounded_(abs(mantissa), exponent, mantissa.negative(), false,
+                  precision, mode);
+}
+
+/**
+ *  @brief Construct a number from `d`, rounded to `precision` bits according to
+ *  `mode`. The conversion is exact if `precision` is at least 53.
+ *  @throw bi::from_float Throws if `d` is a NaN or infinity.
+ */
+bigfloat::bigfloat(double d, bi_bitcount_t precision, rounding mode)
+    : exp_(0), prec_(precision) {
+  check_precision(precision);
+  if (std::isnan(d) || std::isinf(d)) {
+    throw from_float("Cannot convert NaN or infinity to bigfloat.");
+  }
+  if (d == 0) {
+    return;
+  }
+
+  constexpr int mant_dig = std::numeric_limits<double>::digits;
+
+  int exp = 0;
+  const double frac = std::frexp(std::fabs(d), &exp);
+  // Exact, since the significand of a double has `mant_dig` bits
+  assign_rounded_(bi_t{std::ldexp(frac, mant_dig)}, exp - mant_dig, d < 0,
+                  false, precision, mode);
+}
+
+///@}
+
+/**
+ *  @name Accessors
+ */
+///@{
+
+/// Return the mantissa \f$ m \f$ of the number \f$ m \cdot 2^{e} \f$.
+const bi_t& bigfloat::mantissa() const noexcept { return mant_; }
+
+/// Return the exponent \f$ e \f$ of the number \f$ m \cdot 2^{e} \f$.
+int64_t bigfloat::exponent() const noexcept { return exp_; }
+
+/// Return the precision, in bits, of the number.
+bi_bitcount_t bigfloat::precision() const noexcept { return prec_; }
+
+/// Set the precision of the number, rounding it according to `mode`.
+bigfloat& bigfloat::set_precision(bi_bitcount_t precision, rounding mode) {
+  check_precision(precision);
+  assign_rounded_(abs(mant_), exp_, mant_.negative(), false, precision, mode);
+  return *this;
+}
+
+///@}
+
+/**
+ *  @name Unary operators
+ */
+///@{
+
+bigfloat bigfloat::operator+() const { return *this; }
+
+bigfloat bigfloat::operator-() const {
+  bigfloat ret(*this);
+  ret.mant_.negate();
+  return ret;
+}
+
+///@}
+
+/**
+ *  @name Arithmetic operators
+ *  @brief The result is rounded to the larger precision of the operands, with
+ *  `rounding::half_even`.
+ */
+///@{
+
+bigfloat bigfloat::operator+(const bigfloat& other) const {
+  return add(*this, other, std::max(prec_, other.prec_));
+}
+
+bigfloat bigfloat::operator-(const bigfloat& other) const {
+  return sub(*this, other, std::max(prec_, other.prec_));
+}
+
+bigfloat bigfloat::operator*(const bigfloat& other) const {
+  return mul(*this, other, std::max(prec_, other.prec_));
+}
+
+bigfloat bigfloat::operator/(const bigfloat& other) const {
+  return div(*this, other, std::max(prec_, other.prec_));
+}
+
+bigfloat& bigfloat::operator+=(const bigfloat& other) {
+  *this = *this + other;
+  return *this;
+}
+
+bigfloat& bigfloat::operator-=(const bigfloat& other) {
+  *this = *this - other;
+  return *this;
+}
+
+bigfloat& bigfloat::operator*=(const bigfloat& other) {
+  *this = *this * other;
+  return *this;
+}
+
+bigfloat& bigfloat::operator/=(const bigfloat& other) {
+  *this = *this / other;
+  return *this;
+}
+
+///@}
+
+/**
+ *  @name Comparisons
+ *  @brief Compare values, regardless of precision.
+ */
+///@{
+
+std::weak_ordering bigfloat::operator<=>(const bigfloat& other) const {
+  const int s = mant_.sign();
+  const int t = other.mant_.sign();
+  if (s != t || s == 0) {
+    return s <=> t;
+  }
+
+  const auto greater =
+      s > 0 ? std::weak_ordering::greater : std::weak_ordering::less;
+  const auto less =
+      s > 0 ? std::weak_ordering::less : std::weak_ordering::greater;
+
+  // Compare the positions of the most significant bits first
+  const int64_t top = exp_ + static_cast<int64_t>(mant_.bit_length());
+  const int64_t other_top =
+      other.exp_ + static_cast<int64_t>(other.mant_.bit_length());
+  if (top != other_top) {
+    return top > other_top ? greater : less;
+  }
+
+  // Equal tops, so the shift is less than the bit length of either mantissa
+  if (exp_ > other.exp_) {
+    return mant_ << static_cast<bi_bitcount_t>(exp_ - other.exp_) <=>
+           other.mant_;
+  }
+  return mant_ <=> other.mant_
+                       << static_cast<bi_bitcount_t>(other.exp_ - exp_);
+}
+
+bool bigfloat::operator==(const bigfloat& other) const {
+  return exp_ == other.exp_ && mant_ == other.mant_;
+}
+
+///@}
+
+/**
+ *  @brief Return the nearest `double` to the number, with ties rounded to
+ *  even. The result is correctly rounded unless it is subnormal. Values too
+ *  large in magnitude to be represented convert to an infinity.
+ */
+bigfloat::operator double() const {
+  constexpr int mant_dig = std::numeric_limits<double>::digits;
+
+  bigfloat rounded(*this);
+  rounded.set_precision(mant_dig);
+
+  // Beyond this, ldexp() overflows or underflows regardless of the mantissa
+  constexpr int64_t exponent_limit = 4096;
+  const auto exponent = static_cast<int>(
+      std::clamp(rounded.exp_, -exponent_limit, exponent_limit));
+
+  return std::ldexp(static_cast<double>(rounded.mant_), exponent);
+}
+
+/**
+ *  @name Other
+ */
+///@{
+
+/**
+ *  @brief Swap the contents of this number with `other`.
+ *  @complexity O(1)
+ */
+void bigfloat::swap(bigfloat& other) noexcept {
+  mant_.swap(other.mant_);
+  std::swap(exp_, other.exp_);
+  std::swap(prec_, other.prec_);
+}
+
+/**
+ *  @brief Return the number in base-10 scientific notation with `digits`
+ *  significant digits, e.g. `"-1.2500e+3"`, rounded with
+ *  `rounding::half_even`.
+ *  @details If `digits` is zero, enough digits are used that converting the
+ *  string back at the same precision recovers the number, i.e.
+ *  \f$ \lceil p \log_{10} 2 \rceil + 1 \f$ digits for precision \f$ p \f$.
+ */
+std::string bigfloat::to_string(size_t digits) const {
+  if (mant_.sign() == 0) {
+    return "0";
+  }
+
+  constexpr double log10_2 = 0.30102999566398120;
+  if (digits == 0) {
+    digits = static_cast<size_t>(
+                 std::ceil(static_cast<double>(prec_) * log10_2)) +
+             1;
+  }
+
+  // Estimate k such that |x| / 10^{k} has `digits` digits, then correct it
+  const auto bits = static_cast<int64_t>(mant_.bit_length());
+  auto k = static_cast<int64_t>(std::floor(
+               static_cast<double>(bits - 1 + exp_) * log10_2)) -
+           static_cast<int64_t>(digits) + 1;
+
+  const bi_t lower = bi_t::pow(10, digits - 1);
+  const bi_t upper = lower * 10;
+
+  bi_t scaled;
+  while (true) {
+    bi_t num = abs(mant_);
+    bi_t den = 1;
+    if (exp_ >= 0) {
+      num <<= static_cast<bi_bitcount_t>(exp_);
+    } else {
+      den <<= static_cast<bi_bitcount_t>(-exp_);
+    }
+    if (k >= 0) {
+      den *= bi_t::pow(10, bi_t{k});
+    } else {
+      num *= bi_t::pow(10, bi_t{-k});
+    }
+
+    scaled = div_round(num, den, rounding::half_even);
+    if (scaled >= upper) {
+      ++k;
+    } else if (scaled < lower) {
+      --k;
+    } else {
+      break;
+    }
+  }
+
+  const std::string scaled_digits = scaled.to_string();
+  const int64_t exp10 = k + static_cast<int64_t>(digits) - 1;
+
+  std::string result;
+  result.reserve(scaled_digits.size() + 24);
+  if (mant_.negative()) {
+    result.push_back('-');
+  }
+  result.push_back(scaled_digits[0]);
+  if (scaled_digits.size() > 1) {
+    result.push_back('.');
+    result.append(scaled_digits, 1);
+  }
+  result.append(exp10 < 0 ? "e-" : "e+");
+  result.append(std::to_string(exp10 < 0 ? -exp10 : exp10));
+
+  return result;
+}
+
+/// Return -1 if the number is negative, 0 if it is zero, and 1 otherwise.
+int bigfloat::sign() const noexcept { return mant_.sign(); }
+
+///@}
+
+/**
+ *  @name Correctly rounded operations
+ *  @brief Return the exact result of the operation rounded to `precision` bits
+ *  according to `mode`.
+ *  @throw std::invalid_argument Throws if `precision` is zero.
+ */
+///@{
+
+bigfloat bigfloat::add(const bigfloat& a, const bigfloat& b,
+                       bi_bitcount_t precision, rounding mode) {
+  return add_(a, b, false, precision, mode);
+}
+
+bigfloat bigfloat::sub(const bigfloat& a, const bigfloat& b,
+                       bi_bitcount_t precision, rounding mode) {
+  return add_(a, b, true, precision, mode);
+}
+
+bigfloat bigfloat::mul(const bigfloat& a, const bigfloat& b,
+                       bi_bitcount_t precision, rounding mode) {
+  check_precision(precision);
+
+  bigfloat result;
+  result.prec_ = precision;
+  if (a.mant_.sign() == 0 || b.mant_.sign() == 0) {
+    return result;
+  }
+
+  const bool negative = a.mant_.negative() != b.mant_.negative();
+  const int64_t exponent = a.exp_ + b.exp_;
+
+  // Short product: truncate operands that are longer than needed. With
+  // |a| = (a_t + f_a) 2^{t_a} and |b| = (b_t + f_b) 2^{t_b}, where
+  // 0 <= f_a, f_b < 1 and at least one is nonzero (mantissas are odd), the
+  // exact product lies strictly between a_t b_t and a_t b_t + err, in units of
+  // 2^{t_a + t_b}. Of a_t b_t itself, only the leading digits are formed by
+  // `mul_high()`, which gives h B^k <= a_t b_t < (h + s + 1) B^k. If both ends
+  // of the interval round to the same value, so does the exact product.
+  const bi_bitcount_t keep = precision + mul_guard_bits;
+  const bi_bitcount_t bits_a = a.mant_.bit_length();
+  const bi_bitcount_t bits_b = b.mant_.bit_length();
+  if (bits_a > keep || bits_b > keep) {
+    const bi_bitcount_t t_a = bits_a > keep ? bits_a - keep : 0;
+    const bi_bitcount_t t_b = bits_b > keep ? bits_b - keep : 0;
+    const bi_t a_t = abs(a.mant_) >> t_a;
+    const bi_t b_t = abs(b.mant_) >> t_b;
+    const auto e_t = exponent + static_cast<int64_t>(t_a + t_b);
+
+    bi_t err = 1;
+    if (t_a != 0 && t_b != 0) {
+      err += a_t + b_t;
+    } else {
+      err = t_a != 0 ? b_t : a_t;
+    }
+
+    // Drop whole digits so that h keeps at least `keep` bits
+    const bi_bitcount_t bits_t = a_t.bit_length() + b_t.bit_length();
+    const size_t k = bits_t > keep ? (bits_t - keep) / bi_dbits : 0;
+    const size_t s = std::min(a_t.size(), b_t.size());
+    bi_t lo = mul_high(a_t, b_t, a_t.size() + b_t.size() - k);
+    bi_t hi = k != 0 ? lo + s + 1 : lo;
+    lo <<= k * bi_dbits;
+    hi <<= k * bi_dbits;
+    hi += err;
+
+    result.assign_rounded_(std::move(lo), e_t, negative, true, precision,
+                           mode);
+    bigfloat check;
+    check.assign_rounded_(std::move(hi), e_t, negative, false, precision,
+                          mode);
+    if (result == check) {
+      return result;
+    }
+  }
+
+  result.assign_rounded_(abs(a.mant_) * abs(b.mant_), exponent, negative,
+                         false, precision, mode);
+  return result;
+}
+
+/**
+ *  @throw bi::division_by_zero Throws if `b` is zero.
+ */
+bigfloat bigfloat::div(const bigfloat& a, const bigfloat& b,
+                       bi_bitcount_t precision, rounding mode) {
+  check_precision(precision);
+  if (b.mant_.sign() == 0) {
+    throw division_by_zero("Division by zero attempt.");
+  }
+
+  bigfloat result;
+  result.prec_ = precision;
+  if (a.mant_.sign() == 0) {
+    return result;
+  }
+
+  // Scale so that the quotient has at least precision + 2 bits. Bits of the
+  // numerator below that are only needed for the sticky bit, since
+  // floor(floor(x / 2^{t}) / y) = floor(x / (2^{t} y)).
+  bi_t num = abs(a.mant_);
+  bi_t den = abs(b.mant_);
+  const int64_t shift = static_cast<int64_t>(precision + 2) +
+                        static_cast<int64_t>(den.bit_length()) -
+                        static_cast<int64_t>(num.bit_length());
+  bool sticky = false;
+  if (shift >= 0) {
+    num <<= static_cast<bi_bitcount_t>(shift);
+  } else {
+    const auto t = static_cast<bi_bitcount_t>(-shift);
+    sticky = count_trailing_zeros(num) < t;
+    num >>= t;
+  }
+
+  auto [quot, rem] = num.div(den);
+  sticky = sticky || rem.sign() != 0;
+
+  result.assign_rounded_(std::move(quot), a.exp_ - b.exp_ - shift,
+                         a.mant_.negative() != b.mant_.negative(), sticky,
+                         precision, mode);
+  return result;
+}
+
+/**
+ *  @throw std::invalid_argument Throws if `x` is negative.
+ */
+bigfloat bigfloat::sqrt(const bigfloat& x, bi_bitcount_t precision,
+                        rounding mode) {
+  check_precision(precision);
+  if (x.mant_.negative()) {
+    throw std::invalid_argument("Square root of a negative number.");
+  }
+
+  bigfloat result;
+  result.prec_ = precision;
+  if (x.mant_.sign() == 0) {
+    return result;
+  }
+
+  // Scale to an even exponent and at least 2 * (precision + 2) bits, so that
+  // the integer square root has at least precision + 2 bits. Bits below that
+  // are only needed for the sticky bit, since floor(sqrt(n + f)) =
+  // floor(sqrt(n)) for an integer n and 0 <= f < 1.
+  bi_t n = x.mant_;
+  int64_t shift = 2 * static_cast<int64_t>(precision + 2) -
+                  static_cast<int64_t>(n.bit_length());
+  if ((x.exp_ - shift) % 2 != 0) {
+    ++shift;
+  }
+  bool sticky = false;
+  if (shift >= 0) {
+    n <<= static_cast<bi_bitcount_t>(shift);
+  } else {
+    const auto t = static_cast<bi_bitcount_t>(-shift);
+    sticky = count_trailing_zeros(n) < t;
+    n >>= t;
+  }
+
+  bi_t root = isqrt(n);
+  sticky = sticky || root * root != n;
+
+  result.assign_rounded_(std::move(root), (x.exp_ - shift) / 2, false, sticky,
+                         precision, mode);
+  return result;
+}
+
+/// Return the square root of `x` at the precision of `x`.
+bigfloat bigfloat::sqrt(const bigfloat& x) { return sqrt(x, x.prec_); }
+
+///@}
+
+/**
+ *  Set this number to `magnitude * 2^{exponent}` with sign `negative`, rounded
+ *  to `precision` bits according to `mode`. If `sticky`, the exact value lies
+ *  strictly between `magnitude` and `magnitude + 1` units of 2^{exponent}; in
+ *  that case, `magnitude` must have at least `precision + 2` bits, so that the
+ *  rounding position lies above the sticky bit.
+ */
+void bigfloat::assign_rounded_(bi_t magnitude, int64_t exponent, bool negative,
+                               bool sticky, bi_bitcount_t precision,
+                               rounding mode) {
+  assert(!sticky || magnitude.bit_length() >= precision + 2);
+
+  const bi_bitcount_t bits = magnitude.bit_length();
+  if (bits > precision) {
+    const bi_bitcount_t k = bits - precision;
+    const bool half_bit = magnitude.test_bit(k - 1);
+    const bool below = sticky || count_trailing_zeros(magnitude) < k - 1;
+    const int half = half_bit ? static_cast<int>(below) : -1;
+
+    magnitude >>= k;
+    exponent += static_cast<int64_t>(k);
+
+    if (round_away(mode, negative, magnitude.odd(), half,
+                   half_bit || below)) {
+      ++magnitude;
+    }
+  }
+
+  if (magnitude.sign() == 0) {
+    exponent = 0;
+  } else {
+    const bi_bitcount_t zeros = count_trailing_zeros(magnitude);
+    magnitude >>= zeros;
+    exponent += static_cast<int64_t>(zeros);
+  }
+
+  if (exponent > max_exponent || exponent < -max_exponent) {
+    throw overflow_error("Exponent out of range.");
+  }
+
+  if (negative) {
+    magnitude.negate();
+  }
+  mant_.swap(magnitude);
+  exp_ = exponent;
+  prec_ = precision;
+}
+
+/// Return `a + b` (or `a - b`), rounded to `precision` bits.
+bigfloat bigfloat::add_(const bigfloat& a, const bigfloat& b, bool subtract,
+                        bi_bitcount_t precision, rounding mode) {
+  check_precision(precision);
+
+  bigfloat result;
+  result.prec_ = precision;
+
+  const bool b_negative = b.mant_.negative() != subtract;
+  if (b.mant_.sign() == 0) {
+    result.assign_rounded_(abs(a.mant_), a.exp_, a.mant_.negative(), false,
+                           precision, mode);
+    return result;
+  }
+  if (a.mant_.sign() == 0) {
+    result.assign_rounded_(abs(b.mant_), b.exp_, b_negative, false, precision,
+                           mode);
+    return result;
+  }
+
+  // Let x be the operand whose most significant bit is higher
+  const bigfloat* x = &a;
+  const bigfloat* y = &b;
+  bool x_negative = a.mant_.negative();
+  bool y_negative = b_negative;
+  const int64_t top_a = a.exp_ + static_cast<int64_t>(a.mant_.bit_length());
+  const int64_t top_b = b.exp_ + static_cast<int64_t>(b.mant_.bit_length());
+  if (top_b > top_a) {
+    std::swap(x, y);
+    std::swap(x_negative, y_negative);
+  }
+  const int64_t top_y = std::min(top_a, top_b);
+
+  bi_t mx = abs(x->mant_);
+  int64_t ex = x->exp_;
+
+  // Far operand: extend x to at least precision + 3 bits. If |y| is below the
+  // least significant bit of the extended x, then y only contributes a sticky
+  // bit (after borrowing one unit, if y is subtracted).
+  const bi_bitcount_t bits_x = mx.bit_length();
+  const bi_bitcount_t extend = bits_x < precision + 3
+                                   ? precision + 3 - bits_x
+                                   : 0;
+  if (top_y <= ex - static_cast<int64_t>(extend)) {
+    mx <<= extend;
+    ex -= static_cast<int64_t>(extend);
+    if (x_negative != y_negative) {
+      --mx;
+    }
+    result.assign_rounded_(std::move(mx), ex, x_negative, true, precision,
+                           mode);
+    return result;
+  }
+
+  // Otherwise, the operands overlap within a few more bits than the working
+  // precision, and the exact sum is formed
+  bi_t my = abs(y->mant_);
+  const int64_t ey = y->exp_;
+  const int64_t e = std::min(ex, ey);
+  mx <<= static_cast<bi_bitcount_t>(ex - e);
+  my <<= static_cast<bi_bitcount_t>(ey - e);
+
+  bool negative = x_negative;
+  if (x_negative == y_negative) {
+    mx += my;
+  } else {
+    mx -= my;
+    if (mx.negative()) {
+      mx.negate();
+      negative = !negative;
+    }
+  }
+
+  result.assign_rounded_(std::move(mx), e, negative, false, precision, mode);
+  return result;
+}
+
+/**
+ *  @brief Write the number to the output stream `os`, as by `to_string()`.
+ *  @relates bigfloat
+ */
+std::ostream& operator<<(std::ostream& os, const bigfloat& x) {
+  return os << x.to_string();
+}
+
+/**
+ *  @brief Swap the contents of `a` with `b`.
+ *  @relates bigfloat
+ *  @complexity O(1)
+ */
+void swap(bigfloat& a, bigfloat& b) noexcept { a.swap(b); }
+
+}  // namespace bi
@@ -0,0 +1,316 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#include "bi_crt.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "bi_exceptions.hpp"
+#include "constants.hpp"
+#include "uints.hpp"
+
+namespace bi {
+
+namespace {
+
+/// Return the Barrett reciprocal `floor(bi_base^{2s} / n)` of `n > 0`, where
+/// `s = n.size()`.
+bi_t barrett_reciprocal(const bi_t& n) {
+  return (bi_t{1} << (2 * n.size() * bi_dbits)) / n;
+}
+
+/**
+ *  Set `r` to `r mod n` for `r >= 0`, where `mu = barrett_reciprocal(n)`. If
+ *  `r < bi_base^{2s}`, the quotient estimate is at most two below the
+ *  quotient, so this costs two multiplications and at most two subtractions;
+ *  otherwise, falls back to division.
+ */
+void barrett_reduce(bi_t& r, const bi_t& n, const bi_t& mu) {
+  if (r < n) {
+    return;
+  }
+
+  const size_t s = n.size();
+  if (r.size() > 2 * s) {
+    r %= n;
+    return;
+  }
+
+  const bi_t q = ((r >> ((s - 1) * bi_dbits)) * mu) >> ((s + 1) * bi_dbits);
+  r -= q * n;
+  while (r >= n) {
+    r -= n;
+  }
+}
+
+/// Return `a * b mod m` for digits `a, b < m`.
+digit mulmod(digit a, digit b, digit m) noexcept {
+  return static_cast<digit>(static_cast<ddigit>(a) * b % m);
+}
+
+/**
+ *  Return a context for `moduli`, reusing the one of the previous call from the
+ *  same thread if the moduli are the same.
+ */
+const crt_context& cached_context(std::span<const digit> moduli) {
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+  thread_local std::unique_ptr<crt_context> cache;
+
+  if (!cache || !std::ranges::equal(cache->moduli(), moduli)) {
+    cache = std::make_unique<crt_context>(moduli);
+  }
+  return *cache;
+}
+
+}  // namespace
+
+/**
+ *  @class crt_context
+ *  @headerfile "bi_crt.hpp"
+ *  @brief Precomputation for converting between integers and their residues
+ *  modulo a fixed set of pairwise coprime single-digit moduli.
+ *
+ *  For moduli \f$ m_{0}, \ldots, m_{k-1} \f$ with product \f$ M \f$,
+ *  `multi_mod()` maps an integer to its residues and `crt()` maps residues
+ *  back to the unique integer in \f$ [0, M) \f$ that has them (Chinese
+ *  Remainder Theorem).
+ *
+ *  The constructor builds a *subproduct tree*: the leaves are the moduli and
+ *  each node is the product of its two children, so the root is \f$ M \f$.
+ *  Each node above the leaves also gets a Barrett reciprocal, so that
+ *  reductions modulo a node only take multiplications.
+ *  - `multi_mod()` reduces modulo the root and then walks down the tree,
+ *    reducing the remainder of each node modulo its children (a *remainder
+ *    tree*).
+ *  - `crt()` uses \f$ x = \sum_{i} v_{i} M/m_{i} \f$, where
+ *    \f$ v_{i} = r_{i}(M/m_{i})^{-1} \bmod m_{i} \f$, evaluated bottom-up as
+ *    \f$ x_{N} = x_{A} \cdot B + x_{B} \cdot A \f$ for a node \f$ N \f$ with
+ *    children \f$ A, B \f$.
+ *
+ *  Both take \f$ O(\log k) \f$ levels of multiplications of numbers that
+ *  together have the size of \f$ M \f$, instead of the \f$ O(k) \f$
+ *  passes over \f$ M \f$-sized numbers of the naive methods. The inverses of
+ *  \f$ M/m_{i} \bmod m_{i} \f$ are found once, by a remainder tree for
+ *  \f$ M/N \bmod N \f$: \f$ M/A \equiv (M/N \bmod A) \cdot B \pmod{A} \f$.
+ *
+ *  @throw std::bad_alloc Throws in case of memory allocation failure.
+ *  @throw std::invalid_argument Throws if a modulus is zero, if the moduli are
+ *  not pairwise coprime, or if spans of residues and moduli differ in size.
+ */
+
+/**
+ *  @name Constructors
+ */
+///@{
+
+/**
+ *  @brief Build the subproduct tree and the per-modulus constants for
+ *  `moduli`.
+ *  @complexity \f$ O(M(n) \log k) \f$, for \f$ k \f$ moduli with an
+ *  \f$ n \f$-digit product.
+ */
+crt_context::crt_context(std::span<const digit> moduli)
+    : moduli_(moduli.begin(), moduli.end()) {
+  if (std::find(moduli_.begin(), moduli_.end(), 0) != moduli_.end()) {
+    throw std::invalid_argument("Moduli must be nonzero.");
+  }
+
+  tree_.emplace_back(moduli_.begin(), moduli_.end());
+  if (moduli_.empty()) {
+    tree_.push_back({bi_t{1}});
+  }
+  while (tree_.back().size() > 1) {
+    const std::vector<bi_t>& below = tree_.back();
+    std::vector<bi_t> level;
+    level.reserve((below.size() + 1) / 2);
+    for (size_t i = 0; i + 1 < below.size(); i += 2) {
+      level.push_back(below[i] * below[i + 1]);
+    }
+    if (below.size() % 2 != 0) {
+      level.push_back(below.back());
+    }
+    tree_.push_back(std::move(level));
+  }
+
+  reciprocals_.resize(tree_.size());
+  for (size_t h = 1; h < tree_.size(); ++h) {
+    reciprocals_[h].reserve(tree_[h].size());
+    for (const bi_t& node : tree_[h]) {
+      reciprocals_[h].push_back(barrett_reciprocal(node));
+    }
+  }
+
+  // t = M / N mod N for each node N of a level, from the root down
+  std::vector<bi_t> t{modulus() == 1 ? bi_t{0} : bi_t{1}};
+  for (size_t h = tree_.size() - 1; h > 1; --h) {
+    const std::vector<bi_t>& below = tree_[h - 1];
+    std::vector<bi_t> next(below.size());
+    for (size_t i = 0; i < below.size(); ++i) {
+      const size_t sibling = i ^ 1;
+      if (sibling >= below.size()) {
+        next[i] = t[i / 2];
+        continue;
+      }
+      bi_t cofactor = below[sibling];
+      reduce_(cofactor, h - 1, i);
+      next[i] = t[i / 2];
+      reduce_(next[i], h - 1, i);
+      next[i] *= cofactor;
+      reduce_(next[i], h - 1, i);
+    }
+    t = std::move(next);
+  }
+
+  cofactor_inverses_.resize(moduli_.size());
+  for (size_t i = 0; i < moduli_.size(); ++i) {
+    const digit m = moduli_[i];
+    const size_t sibling = i ^ 1;
+    digit t_leaf = t[i / 2].mod_ui(m);
+    if (sibling < moduli_.size() && tree_.size() > 1) {
+      t_leaf = mulmod(t_leaf, moduli_[sibling] % m, m);
+    }
+    cofactor_inverses_[i] = uints::inverse_mod(t_leaf, m);
+    if (m != 1 && cofactor_inverses_[i] == 0) {
+      throw std::invalid_argument("Moduli must be pairwise coprime.");
+    }
+  }
+}
+
+///@}
+
+/**
+ *  @name Accessors
+ */
+///@{
+
+/// Return the number of moduli.
+size_t crt_context::size() const noexcept { return moduli_.size(); }
+
+/// Return the moduli.
+std::span<const digit> crt_context::moduli() const noexcept { return moduli_; }
+
+/// Return the product of the moduli (1 if there are none).
+const bi_t& crt_context::modulus() const noexcept { return tree_.back()[0]; }
+
+///@}
+
+/**
+ *  @name Conversions
+ */
+///@{
+
+/**
+ *  @brief Return the unique integer in `[0, modulus())` that is congruent to
+ *  `residues[i]` modulo `moduli()[i]` for each `i`. Residues need not be
+ *  reduced.
+ *  @complexity \f$ O(M(n) \log k) \f$
+ */
+bi_t crt_context::crt(std::span<const digit> residues) const {
+  if (residues.size() != moduli_.size()) {
+    throw std::invalid_argument("Moduli and residues differ in size.");
+  }
+
+  std::vector<bi_t> x(moduli_.size());
+  for (size_t i = 0; i < moduli_.size(); ++i) {
+    const digit m = moduli_[i];
+    x[i] = mulmod(residues[i] % m, cofactor_inverses_[i], m);
+  }
+
+  // x_N = x_A * B + x_B * A
+  for (size_t h = 1; h < tree_.size() && !moduli_.empty(); ++h) {
+    const std::vector<bi_t>& below = tree_[h - 1];
+    std::vector<bi_t> next(tree_[h].size());
+    for (size_t i = 0; i + 1 < below.size(); i += 2) {
+      next[i / 2] = x[i] * below[i + 1];
+      next[i / 2] += x[i + 1] * below[i];
+    }
+    if (below.size() % 2 != 0) {
+      next.back() = std::move(x.back());
+    }
+    x = std::move(next);
+  }
+
+  if (x.empty()) {
+    return 0;
+  }
+  if (tree_.size() > 1) {
+    reduce_(x[0], tree_.size() - 1, 0);
+  }
+  return std::move(x[0]);
+}
+
+/**
+ *  @brief Set `residues[i]` to the least nonnegative residue of `x` modulo
+ *  `moduli()[i]` for each `i`.
+ *  @complexity \f$ O(D(m, n) + M(n) \log k) \f$ for an \f$ m \f$-digit `x`,
+ *  where \f$ D(m, n) \f$ is the cost of reducing `x` modulo `modulus()`.
+ */
+void crt_context::multi_mod(const bi_t& x, std::span<digit> residues) const {
+  if (residues.size() != moduli_.size()) {
+    throw std::invalid_argument("Moduli and residues differ in size.");
+  }
+  if (moduli_.empty()) {
+    return;
+  }
+
+  std::vector<bi_t> r{mod_euclid(x, modulus())};
+  for (size_t h = tree_.size() - 1; h > 1; --h) {
+    std::vector<bi_t> next(tree_[h - 1].size());
+    for (size_t i = 0; i < next.size(); ++i) {
+      next[i] = r[i / 2];
+      reduce_(next[i], h - 1, i);
+    }
+    r = std::move(next);
+  }
+
+  for (size_t i = 0; i < moduli_.size(); ++i) {
+    residues[i] = r[i / 2].mod_ui(moduli_[i]);
+  }
+}
+
+/// @brief Return the residues of `x`, as the other overload of `multi_mod()`.
+std::vector<digit> crt_context::multi_mod(const bi_t& x) const {
+  std::vector<digit> residues(moduli_.size());
+  multi_mod(x, residues);
+  return residues;
+}
+
+///@}
+
+/// Set `r >= 0` to `r` modulo the node `tree_[level][index]`, `level >= 1`.
+void crt_context::reduce_(bi_t& r, size_t level, size_t index) const {
+  barrett_reduce(r, tree_[level][index], reciprocals_[level][index]);
+}
+
+/**
+ *  @brief Return the unique integer in `[0, M)`, where `M` is the product of
+ *  the pairwise coprime `moduli`, that is congruent to `residues[i]` modulo
+ *  `moduli[i]` for each `i`.
+ *  @details Uses a `crt_context`, which is kept per thread and reused while
+ *  consecutive calls (of this function or `multi_mod()`) pass the same moduli.
+ *  @throw std::invalid_argument Throws if a modulus is zero, if the moduli are
+ *  not pairwise coprime, or if the spans differ in size.
+ *  @relates crt_context
+ */
+bi_t crt(std::span<const digit> residues, std::span<const digit> moduli) {
+  return cached_context(moduli).crt(residues);
+}
+
+/**
+ *  @brief Return the least nonnegative residues of `x` modulo each of the
+ *  pairwise coprime `moduli`.
+ *  @details Uses a `crt_context`, as `crt()`.
+ *  @throw std::invalid_argument Throws if a modulus is zero or if the moduli
+ *  are not pairwise coprime.
+ *  @relates crt_context
+ */
+std::vector<digit> multi_mod(const bi_t& x, std::span<const digit> moduli) {
+  return cached_context(moduli).multi_mod(x);
+}
+
+}  // namespace bi
@@ -0,0 +1,498 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#include "bi_decimal.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <compare>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "bi_exceptions.hpp"
+#include "power_cache.hpp"
+#include "rounding.hpp"
+
+namespace bi {
+
+namespace {
+
+// Powers of ten below 10^{pow10_cache_limit} are cached per thread
+constexpr uint64_t pow10_cache_limit = 1024;
+
+// A deque, so that references to cached powers survive growth of the cache
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+thread_local std::deque<bi_t> pow10_cache{bi_t{1}};
+
+/**
+ *  Return 10^{k}, either from the cache or computed into `storage`. Powers
+ *  below the digit base are single-digit values, so multiplying or dividing by
+ *  them takes a single pass over the other operand.
+ */
+const bi_t& pow10(uint64_t k, bi_t& storage) {
+  if (k >= pow10_cache_limit) {
+    storage = power_cache::pow(10, k);
+    return storage;
+  }
+
+  while (pow10_cache.size() <= k) {
+    pow10_cache.push_back(pow10_cache.back() * 10);
+  }
+
+  return pow10_cache[k];
+}
+
+int32_t checked_exponent(int64_t exponent) {
+  if (exponent < std::numeric_limits<int32_t>::min() ||
+      exponent > std::numeric_limits<int32_t>::max()) {
+    throw overflow_error("Decimal exponent out of range.");
+  }
+  return static_cast<int32_t>(exponent);
+}
+
+}  // namespace
+
+/**
+ *  @class decimal
+ *  @headerfile "bi_decimal.hpp"
+ *  @brief Arbitrary-precision decimal number type built on `bi_t`.
+ *
+ *  An instance of `decimal` represents the number
+ *  \f$ c \cdot 10^{e} \f$, where the coefficient \f$ c \f$ is a `bi_t` and the
+ *  exponent \f$ e \f$ is an `int32_t`. The scale of the number is
+ *  \f$ -e \f$, i.e. the number of digits after the decimal point.
+ *
+ *  Addition, subtraction and multiplication are exact: the exponent of a sum is
+ *  the smaller of the exponents of the operands and the exponent of a product
+ *  is the sum of their exponents. Operations that cannot be exact, i.e.
+ *  `rescale()` to a larger exponent and `div()`, take the exponent of the
+ *  result and a `rounding` mode, and round the exact result correctly.
+ *
+ *  Numbers that differ only in their exponent, such as `1.5` and `1.50`,
+ *  compare equal but have different string representations.
+ *
+ *  Powers of ten used to align exponents are cached. Powers of ten that fit in
+ *  a single digit are divided by using a precomputed reciprocal, in place of a
+ *  hardware division per digit.
+ *
+ *  @throw std::bad_alloc Throws in case of memory allocation failure.
+ *  @throw bi::overflow_error Throws if the exponent of a result does not fit in
+ *  an `int32_t`.
+ *  @throw bi::division_by_zero Throws if a division by zero attempt is
+ *  detected.
+ */
+
+/**
+ *  @name Constructors
+ */
+///@{
+
+/// Default constructor. The number is initialized to zero, with exponent zero.
+decimal::decimal() : exp_(0) {}
+
+/// Construct the number `coeff * 10^{exp}`.
+decimal::decimal(const bi_t& coeff, int32_t exp) : coeff_(coeff), exp_(exp) {}
+
+/**
+ *  @brief Construct a number from a string in plain or scientific notation,
+ *  e.g. `"-123.4500"` or `"1.5e-3"`.
+ *  @throw std::invalid_argument Throws if a parsing error occurs, or if a null
+ *  pointer is provided.
+ *  @throw bi::overflow_error Throws if the exponent does not fit in an
+ *  `int32_t`.
+ *  @details Allows leading whitespace and a plus/minus sign. The exponent of
+ *  the number is the exponent in the string minus the number of digits after
+ *  the decimal point, so that `decimal{"1.50"}` has coefficient `150` and
+ *  exponent `-2`. The digits are converted to the coefficient in base-10
+ *  batches, like `bi_t(const std::string&)`.
+ */
+decimal::decimal(const std::string& s) : exp_(0) {
+  const size_t n = s.size();
+  size_t i = 0;
+  while (i < n && std::isspace(static_cast<unsigned char>(s[i]))) {
+    ++i;
+  }
+
+  std::string digits;
+  digits.reserve(n - i);
+  if (i < n && (s[i] == '-' || s[i] == '+')) {
+    digits.push_back(s[i++]);
+  }
+
+  int64_t fraction_digits = 0;
+  bool seen_point = false;
+  bool seen_digit = false;
+  for (; i < n; ++i) {
+    if (std::isdigit(static_cast<unsigned char>(s[i]))) {
+      digits.push_back(s[i]);
+      seen_digit = true;
+      fraction_digits += static_cast<int64_t>(seen_point);
+    } else if (s[i] == '.' && !seen_point) {
+      seen_point = true;
+    } else {
+      break;
+    }
+  }
+  if (!seen_digit) {
+    throw std::invalid_argument("Invalid string format.");
+  }
+
+  int64_t exponent = 0;
+  if (i < n && (s[i] == 'e' || s[i] == 'E')) {
+    ++i;
+    bool exponent_negative = false;
+    if (i < n && (s[i] == '-' || s[i] == '+')) {
+      exponent_negative = s[i++] == '-';
+    }
+
+    // Saturate, so that out of range exponents are reported as such
+    constexpr int64_t exponent_limit = int64_t{1} << 40;
+    const size_t start = i;
+    for (; i < n && std::isdigit(static_cast<unsigned char>(s[i])); ++i) {
+      exponent = std::min(exponent * 10 + (s[i] - '0'), exponent_limit);
+    }
+    if (i == start) {
+      throw std::invalid_argument("Invalid string format.");
+    }
+    if (exponent_negative) {
+      exponent = -exponent;
+    }
+  }
+
+  if (i != n) {
+    throw std::invalid_argument("Invalid string format.");
+  }
+
+  exp_ = checked_exponent(exponent - fraction_digits);
+  coeff_ = bi_t(digits);
+}
+
+decimal::decimal(const char* s) : exp_(0) {
+  if (s == nullptr) {
+    throw std::invalid_argument("Null string pointer provided.");
+  }
+  *this = decimal(std::string(s));
+}
+
+///@}
+
+/**
+ *  @name Accessors
+ */
+///@{
+
+/// Return the coefficient \f$ c \f$ of the number \f$ c \cdot 10^{e} \f$.
+const bi_t& decimal::coefficient() const noexcept { return coeff_; }
+
+/// Return the exponent \f$ e \f$ of the number \f$ c \cdot 10^{e} \f$.
+int32_t decimal::exponent() const noexcept { return exp_; }
+
+/// Return the scale, i.e. the negated exponent, of the number.
+int32_t decimal::scale() const noexcept {
+  // Saturate rather than overflow for the smallest exponent
+  return exp_ == std::numeric_limits<int32_t>::min()
+             ? std::numeric_limits<int32_t>::max()
+             : -exp_;
+}
+
+///@}
+
+/**
+ *  @name Rounding
+ */
+///@{
+
+/**
+ *  @brief Return the number with exponent `exponent`, rounded according to
+ *  `mode` if `exponent` is larger than the current exponent.
+ *  @details Decreasing the exponent multiplies the coefficient by a power of
+ *  ten and is exact. Increasing the exponent by \f$ k \f$ divides the
+ *  coefficient by \f$ 10^{k} \f$; if the coefficient has at most
+ *  \f$ 3(k - 1) \f$ bits, it is less than half of \f$ 10^{k} \f$ and the
+ *  division is skipped.
+ */
+decimal decimal::rescale(int32_t exponent, rounding mode) const {
+  const int64_t diff = static_cast<int64_t>(exponent) - exp_;
+  if (diff == 0) {
+    return *this;
+  }
+
+  bi_t storage;
+  if (diff < 0) {
+    return {coeff_ * pow10(static_cast<uint64_t>(-diff), storage), exponent};
+  }
+
+  const auto k = static_cast<uint64_t>(diff);
+  if (coeff_.bit_length() <= 3 * (k - 1)) {
+    const bool inexact = coeff_.sign() != 0;
+    bi_t result;
+    if (round_away(mode, coeff_.negative(), false, -1, inexact)) {
+      result = coeff_.sign();
+    }
+    return {result, exponent};
+  }
+
+  return {div_round(coeff_, pow10(k, storage), mode), exponent};
+}
+
+/// Return the number with scale `scale`. See `rescale()`.
+decimal decimal::with_scale(int32_t scale, rounding mode) const {
+  return rescale(checked_exponent(-static_cast<int64_t>(scale)), mode);
+}
+
+///@}
+
+/**
+ *  @name Unary operators
+ */
+///@{
+
+decimal decimal::operator+() const { return *this; }
+
+decimal decimal::operator-() const {
+  decimal ret(*this);
+  ret.coeff_.negate();
+  return ret;
+}
+
+///@}
+
+/**
+ *  @name Arithmetic operators
+ *  @throw bi::overflow_error Throws if the exponent of the product does not
+ *  fit in an `int32_t`.
+ */
+///@{
+
+decimal decimal::operator+(const decimal& other) const {
+  decimal ret(*this);
+  ret.add_(other, false);
+  return ret;
+}
+
+decimal decimal::operator-(const decimal& other) const {
+  decimal ret(*this);
+  ret.add_(other, true);
+  return ret;
+}
+
+decimal decimal::operator*(const decimal& other) const {
+  decimal ret(*this);
+  ret *= other;
+  return ret;
+}
+
+decimal& decimal::operator+=(const decimal& other) {
+  return add_(other, false);
+}
+
+decimal& decimal::operator-=(const decimal& other) {
+  return add_(other, true);
+}
+
+decimal& decimal::operator*=(const decimal& other) {
+  const int32_t exponent =
+      checked_exponent(static_cast<int64_t>(exp_) + other.exp_);
+  coeff_ *= other.coeff_;
+  exp_ = exponent;
+  return *this;
+}
+
+///@}
+
+/**
+ *  @name Comparisons
+ *  @details Operands with different exponents are compared by the bit lengths
+ *  of their coefficients first, which brackets their magnitudes to within a
+ *  factor of two, so that the coefficient is only scaled by a power of ten
+ *  when the magnitudes are close.
+ */
+///@{
+
+std::weak_ordering decimal::operator<=>(const decimal& other) const {
+  const int s = coeff_.sign();
+  const int t = other.coeff_.sign();
+  if (s != t || s == 0) {
+    return s <=> t;
+  }
+
+  if (exp_ == other.exp_) {
+    return coeff_ <=> other.coeff_;
+  }
+
+  // 10^{e + (l - 1) log10(2)} <= |c * 10^{e}| < 10^{e + l log10(2)}, where l is
+  // the bit length of c. A margin of one decimal digit absorbs the rounding
+  // errors of the floating-point estimates.
+  constexpr double log10_2 = 0.30102999566398120;
+  const auto log10_bounds = [](const decimal& x) {
+    const auto bits = static_cast<double>(x.coeff_.bit_length());
+    return std::pair{(bits - 1) * log10_2 + x.exp_, bits * log10_2 + x.exp_};
+  };
+  const auto [lo, hi] = log10_bounds(*this);
+  const auto [other_lo, other_hi] = log10_bounds(other);
+  const auto greater = s > 0 ? std::weak_ordering::greater
+                             : std::weak_ordering::less;
+  const auto less = s > 0 ? std::weak_ordering::less
+                          : std::weak_ordering::greater;
+  if (hi + 1 < other_lo) {
+    return less;
+  }
+  if (other_hi + 1 < lo) {
+    return greater;
+  }
+
+  bi_t storage;
+  const int64_t diff = static_cast<int64_t>(exp_) - other.exp_;
+  if (diff > 0) {
+    return coeff_ * pow10(static_cast<uint64_t>(diff), storage) <=>
+           other.coeff_;
+  }
+  return coeff_ <=>
+         other.coeff_ * pow10(static_cast<uint64_t>(-diff), storage);
+}
+
+bool decimal::operator==(const decimal& other) const {
+  if (exp_ == other.exp_) {
+    return coeff_ == other.coeff_;
+  }
+  return (*this <=> other) == 0;
+}
+
+///@}
+
+/**
+ *  @name Other
+ */
+///@{
+
+/**
+ *  @brief Swap the contents of this number with `other`.
+ *  @complexity O(1)
+ */
+void decimal::swap(decimal& other) noexcept {
+  coeff_.swap(other.coeff_);
+  std::swap(exp_, other.exp_);
+}
+
+/**
+ *  @brief Return the number as a base-10 string in plain notation, with
+ *  `scale()` digits after the decimal point if the scale is positive.
+ */
+std::string decimal::to_string() const {
+  std::string digits = coeff_.to_string();
+  if (exp_ >= 0) {
+    if (coeff_.sign() != 0) {
+      digits.append(static_cast<size_t>(exp_), '0');
+    }
+    return digits;
+  }
+
+  const size_t sign_length = coeff_.negative() ? 1 : 0;
+  const auto scale = static_cast<size_t>(-static_cast<int64_t>(exp_));
+  const size_t length = digits.size() - sign_length;
+  if (length <= scale) {
+    digits.insert(sign_length, scale - length + 1, '0');
+  }
+  digits.insert(digits.size() - scale, 1, '.');
+
+  return digits;
+}
+
+/// Return -1 if the number is negative, 0 if it is zero, and 1 otherwise.
+int decimal::sign() const noexcept { return coeff_.sign(); }
+
+///@}
+
+/**
+ *  @name Static
+ */
+///@{
+
+/**
+ *  @brief Return `a / b` with exponent `exponent`, correctly rounded according
+ *  to `mode`.
+ *  @throw bi::division_by_zero Throws if `b` is zero.
+ *  @details With \f$ a = c_a 10^{e_a} \f$ and \f$ b = c_b 10^{e_b} \f$, the
+ *  coefficient of the result is \f$ c_a 10^{e_a - e_b - e} / c_b \f$ rounded to
+ *  an integer, which requires a single division.
+ *
+ *  Example:
+ *  @code
+ *  decimal q = decimal::div(decimal{"10"}, decimal{"3"}, -2);  // 3.33
+ *  @endcode
+ */
+decimal decimal::div(const decimal& a, const decimal& b, int32_t exponent,
+                     rounding mode) {
+  if (b.coeff_.sign() == 0) {
+    throw division_by_zero("Division by zero attempt.");
+  }
+
+  const int64_t shift = static_cast<int64_t>(a.exp_) - b.exp_ - exponent;
+
+  bi_t storage;
+  if (shift >= 0) {
+    const bi_t num = a.coeff_ * pow10(static_cast<uint64_t>(shift), storage);
+    return {div_round(num, b.coeff_, mode), exponent};
+  }
+  const bi_t den = b.coeff_ * pow10(static_cast<uint64_t>(-shift), storage);
+  return {div_round(a.coeff_, den, mode), exponent};
+}
+
+///@}
+
+/// Add `other` to (or subtract it from) this number in place.
+decimal& decimal::add_(const decimal& other, bool subtract) {
+  if (exp_ == other.exp_) {
+    if (subtract) {
+      coeff_ -= other.coeff_;
+    } else {
+      coeff_ += other.coeff_;
+    }
+    return *this;
+  }
+
+  bi_t storage;
+  const int64_t diff = static_cast<int64_t>(exp_) - other.exp_;
+  if (diff > 0) {
+    coeff_ *= pow10(static_cast<uint64_t>(diff), storage);
+    exp_ = other.exp_;
+    if (subtract) {
+      coeff_ -= other.coeff_;
+    } else {
+      coeff_ += other.coeff_;
+    }
+  } else {
+    const bi_t scaled =
+        other.coeff_ * pow10(static_cast<uint64_t>(-diff), storage);
+    if (subtract) {
+      coeff_ -= scaled;
+    } else {
+      coeff_ += scaled;
+    }
+  }
+
+  return *this;
+}
+
+/**
+ *  @brief Write the number to the output stream `os`, as by `to_string()`.
+ *  @relates decimal
+ */
+std::ostream& operator<<(std::ostream& os, const decimal& x) {
+  return os << x.to_string();
+}
+
+/**
+ *  @brief Swap the contents of `a` with `b`.
+ *  @relates decimal
+ *  @complexity O(1)
+ */
+void swap(decimal& a, decimal& b) noexcept { a.swap(b); }
+
+}  // namespace bi
@@ -0,0 +1,230 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#include "bi_intern.hpp"
+
+#include <array>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace bi {
+
+namespace {
+
+/// Interned integers with the same hash share a bucket of this table.
+class intern_table {
+ public:
+  /**
+   *  Return the handle of the interned integer equal to `x`, interning a copy
+   *  of `x` if there is none. Lookups of integers that are already interned
+   *  only take a shared lock of one shard.
+   */
+  std::shared_ptr<const bi_t> intern(const bi_t& x) {
+    const size_t hash = hash_value(x);
+    shard& s = shards_[hash % shard_count];
+
+    {
+      const std::shared_lock<std::shared_mutex> lock(s.mutex);
+      if (std::shared_ptr<const bi_t> found = find(s, hash, x)) {
+        return found;
+      }
+    }
+
+    // Created before taking the lock, so that if it is not needed, its
+    // remover runs after the lock is released
+    std::shared_ptr<const bi_t> ptr(new bi_t(x), remover{this, hash});
+    const std::unique_lock<std::shared_mutex> lock(s.mutex);
+    if (std::shared_ptr<const bi_t> found = find(s, hash, x)) {
+      return found;
+    }
+    s.entries.emplace(hash, entry{ptr.get(), ptr});
+    return ptr;
+  }
+
+  /// Return the number of entries, including any that are being removed.
+  size_t size() noexcept {
+    size_t n = 0;
+    for (shard& s : shards_) {
+      const std::shared_lock<std::shared_mutex> lock(s.mutex);
+      n += s.entries.size();
+    }
+    return n;
+  }
+
+ private:
+  static constexpr size_t shard_count = 64;
+
+  struct entry {
+    // Identifies the entry once `handle` has expired
+    const bi_t* value;
+    std::weak_ptr<const bi_t> handle;
+  };
+
+  struct shard {
+    std::shared_mutex mutex;
+    std::unordered_multimap<size_t, entry> entries;
+  };
+
+  /**
+   *  Deleter of interned integers. Removes the entry of an integer when its
+   *  last handle is destroyed, so that the table only holds integers in use.
+   */
+  struct remover {
+    intern_table* table;
+    size_t hash;
+
+    void operator()(const bi_t* value) const noexcept {
+      shard& s = table->shards_[hash % shard_count];
+      {
+        const std::unique_lock<std::shared_mutex> lock(s.mutex);
+        const auto [first, last] = s.entries.equal_range(hash);
+        for (auto it = first; it != last; ++it) {
+          if (it->second.value == value) {
+            s.entries.erase(it);
+            break;
+          }
+        }
+      }
+      delete value;  // NOLINT(cppcoreguidelines-owning-memory)
+    }
+  };
+
+  std::array<shard, shard_count> shards_;
+
+  /// Return a handle of an integer equal to `x` in `s`, or null.
+  static std::shared_ptr<const bi_t> find(const shard& s, size_t hash,
+                                          const bi_t& x) {
+    const auto [first, last] = s.entries.equal_range(hash);
+    for (auto it = first; it != last; ++it) {
+      // The integer is alive while its entry is in the table, even if its
+      // handle has expired and its remover waits for the lock. No handle is
+      // released here, which could run a remover while the lock is held.
+      if (*it->second.value == x) {
+        if (std::shared_ptr<const bi_t> ptr = it->second.handle.lock()) {
+          return ptr;
+        }
+      }
+    }
+    return nullptr;
+  }
+};
+
+/// Return the process-wide table.
+intern_table& table() {
+  // Never destroyed, so that handles in static storage may outlive it
+  static intern_table* const instance = new intern_table;
+  return *instance;
+}
+
+}  // namespace
+
+/**
+ *  @class interned
+ *  @headerfile "bi_intern.hpp"
+ *  @brief Shared, immutable handle of an interned integer.
+ *
+ *  `intern()` returns handles such that handles of equal integers refer to
+ *  the same `bi_t`, so that equal large integers created over and over (e.g.
+ *  factorials or powers) are stored once, and comparing handles is a pointer
+ *  comparison. `std::hash<interned>` hashes the pointer.
+ *
+ *  The table of interned integers is shared by all threads and is safe to use
+ *  concurrently. It is sharded by hash, and lookups of integers that are
+ *  already interned only take a shared lock. An integer stays interned while
+ *  any handle of it exists, and is removed from the table with its last
+ *  handle.
+ *
+ *  @throw std::bad_alloc Throws in case of memory allocation failure.
+ */
+
+/**
+ *  @name Constructors
+ */
+///@{
+
+/// Default constructor. The handle refers to the interned 0.
+interned::interned() : ptr_(table().intern(bi_t{})) {}
+
+interned::interned(std::shared_ptr<const bi_t> ptr) noexcept
+    : ptr_(std::move(ptr)) {}
+
+///@}
+
+/**
+ *  @name Accessors
+ */
+///@{
+
+/// Return the interned integer.
+const bi_t& interned::get() const noexcept { return *ptr_; }
+
+/// Return the interned integer.
+const bi_t& interned::operator*() const noexcept { return *ptr_; }
+
+/// Return a pointer to the interned integer.
+const bi_t* interned::operator->() const noexcept { return ptr_.get(); }
+
+///@}
+
+/**
+ *  @name Comparisons
+ */
+///@{
+
+/**
+ *  @brief Return whether the handles refer to equal integers.
+ *  @complexity O(1)
+ */
+bool interned::operator==(const interned& other) const noexcept {
+  return ptr_ == other.ptr_;
+}
+
+///@}
+
+/**
+ *  @name Other
+ */
+///@{
+
+/**
+ *  @brief Swap the contents of this handle with `other`.
+ *  @complexity O(1)
+ */
+void interned::swap(interned& other) noexcept { ptr_.swap(other.ptr_); }
+
+///@}
+
+/**
+ *  @brief Return the handle of the interned integer equal to `x`, interning a
+ *  copy of `x` first if no equal integer is interned.
+ *  @relates interned
+ *  @complexity O(n) expected, for hashing and comparing `x`.
+ */
+interned intern(const bi_t& x) { return interned(table().intern(x)); }
+
+/**
+ *  @brief Return the number of interned integers.
+ *  @relates interned
+ */
+size_t interned_count() noexcept { return table().size(); }
+
+/**
+ *  @brief Write the interned integer to the output stream `os`.
+ *  @relates interned
+ */
+std::ostream& operator<<(std::ostream& os, const interned& x) {
+  return os << x.get();
+}
+
+/**
+ *  @brief Swap the contents of `a` with `b`.
+ *  @relates interned
+ *  @complexity O(1)
+ */
+void swap(interned& a, interned& b) noexcept { a.swap(b); }
+
+}  // namespace bi
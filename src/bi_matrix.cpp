@@ -0,0 +1,376 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#include "bi_matrix.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+#include "parallel.hpp"
+
+namespace bi {
+
+namespace {
+
+// Products with a smaller dimension use the classical algorithm
+constexpr size_t strassen_threshold = 64;
+// Products estimated to take fewer digit multiplications run on one thread
+constexpr double parallel_threshold = 1 << 20;
+
+/// Return the largest number of digits of an entry of `x`.
+size_t max_digits(const matrix& x) {
+  size_t digits = 0;
+  for (size_t i = 0; i < x.rows(); ++i) {
+    for (const bi_t& entry : x.row(i)) {
+      digits = std::max(digits, entry.size());
+    }
+  }
+  return digits;
+}
+
+/// Return the number of threads to use for the product `a * b`.
+size_t threads_for(const matrix& a, const matrix& b) {
+  const double work = static_cast<double>(a.rows()) *
+                      static_cast<double>(a.cols()) *
+                      static_cast<double>(b.cols()) *
+                      static_cast<double>(max_digits(a)) *
+                      static_cast<double>(max_digits(b));
+  return work >= parallel_threshold ? parallel::max_threads() : 1;
+}
+
+/**
+ *  Add `a * b` to `c`, entry by entry with `addmul()`, so that each entry of
+ *  `c` serves as a preallocated accumulator. The rows of `c` are distributed
+ *  over threads.
+ */
+void mul_classical(matrix& c, const matrix& a, const matrix& b) {
+  parallel::for_each_index(
+      a.rows(),
+      [&](size_t i) {
+        const std::span<bi_t> c_row = c.row(i);
+        const std::span<const bi_t> a_row = a.row(i);
+        for (size_t l = 0; l < a.cols(); ++l) {
+          const bi_t& a_il = a_row[l];
+          if (a_il == 0) {
+            continue;
+          }
+          const std::span<const bi_t> b_row = b.row(l);
+          for (size_t j = 0; j < b.cols(); ++j) {
+            addmul(c_row[j], a_il, b_row[j]);
+          }
+        }
+      },
+      threads_for(a, b));
+}
+
+/// Return the `rows` x `cols` block of `x` at `(r, c)`, padded with zeros.
+matrix block(const matrix& x, size_t r, size_t c, size_t rows, size_t cols) {
+  matrix result(rows, cols);
+  for (size_t i = 0; i < rows && r + i < x.rows(); ++i) {
+    for (size_t j = 0; j < cols && c + j < x.cols(); ++j) {
+      result(i, j) = x(r + i, c + j);
+    }
+  }
+  return result;
+}
+
+/// Move the entries of `x` that fit in `dst` to its block at `(r, c)`.
+void place(matrix& dst, matrix&& x, size_t r, size_t c) {
+  for (size_t i = 0; i < x.rows() && r + i < dst.rows(); ++i) {
+    for (size_t j = 0; j < x.cols() && c + j < dst.cols(); ++j) {
+      dst(r + i, c + j) = std::move(x(i, j));
+    }
+  }
+}
+
+/**
+ *  Return `a * b` by the Strassen-Winograd algorithm, which multiplies the
+ *  blocks of a 2 x 2 partition with 7 block products and 15 block additions
+ *  instead of 8 block products, recursing until a dimension is below
+ *  `strassen_threshold`. Odd dimensions are padded with zeros.
+ */
+matrix mul_strassen(const matrix& a, const matrix& b) {
+  const size_t m = a.rows();
+  const size_t k = a.cols();
+  const size_t n = b.cols();
+  if (std::min({m, k, n}) < strassen_threshold) {
+    matrix c(m, n);
+    mul_classical(c, a, b);
+    return c;
+  }
+
+  const size_t mh = (m + 1) / 2;
+  const size_t kh = (k + 1) / 2;
+  const size_t nh = (n + 1) / 2;
+  const matrix a11 = block(a, 0, 0, mh, kh);
+  const matrix a12 = block(a, 0, kh, mh, kh);
+  const matrix a21 = block(a, mh, 0, mh, kh);
+  const matrix a22 = block(a, mh, kh, mh, kh);
+  const matrix b11 = block(b, 0, 0, kh, nh);
+  const matrix b12 = block(b, 0, nh, kh, nh);
+  const matrix b21 = block(b, kh, 0, kh, nh);
+  const matrix b22 = block(b, kh, nh, kh, nh);
+
+  const matrix s1 = a21 + a22;
+  const matrix s2 = s1 - a11;
+  const matrix s3 = a11 - a21;
+  const matrix s4 = a12 - s2;
+  const matrix t1 = b12 - b11;
+  const matrix t2 = b22 - t1;
+  const matrix t3 = b22 - b12;
+  const matrix t4 = t2 - b21;
+
+  const std::array<std::pair<const matrix*, const matrix*>, 7> factors{{
+      {&a11, &b11},
+      {&a12, &b21},
+      {&s4, &b22},
+      {&a22, &t4},
+      {&s1, &t1},
+      {&s2, &t2},
+      {&s3, &t3},
+  }};
+  std::array<matrix, 7> p;
+  parallel::for_each_index(
+      p.size(),
+      [&](size_t i) {
+        p[i] = mul_strassen(*factors[i].first, *factors[i].second);
+      },
+      threads_for(a, b));
+
+  matrix c11 = p[0] + p[1];
+  matrix u2 = std::move(p[0]);
+  u2 += p[5];
+  matrix c12 = u2 + p[4];
+  c12 += p[2];
+  u2 += p[6];  // U3
+  matrix c21 = u2 - p[3];
+  u2 += p[4];  // C22
+
+  matrix c(m, n);
+  place(c, std::move(c11), 0, 0);
+  place(c, std::move(c12), 0, nh);
+  place(c, std::move(c21), mh, 0);
+  place(c, std::move(u2), mh, nh);
+  return c;
+}
+
+}  // namespace
+
+/**
+ *  @class matrix
+ *  @headerfile "bi_matrix.hpp"
+ *  @brief Dense matrix of `bi_t` entries, stored row by row.
+ *
+ *  Multiplication avoids the temporaries that a naive triple loop over
+ *  `operator*` and `operator+` creates for every entry product:
+ *  - Each entry of the result is a preallocated accumulator that is updated
+ *    in place with `addmul()`, so that its storage is reused by all of the
+ *    products that contribute to it.
+ *  - If all dimensions are large, the Strassen-Winograd algorithm trades one
+ *    of the eight block products of a 2 x 2 partition for block additions,
+ *    which are cheap relative to products of large integers.
+ *  - Rows of classical products and the block products of the top level of
+ *    Strassen-Winograd run on multiple threads when the product is large
+ *    enough to pay for them.
+ *
+ *  @throw std::bad_alloc Throws in case of memory allocation failure.
+ *  @throw std::invalid_argument Throws if the dimensions of the operands of an
+ *  operation do not match, or if the rows given to a constructor differ in
+ *  length.
+ */
+
+/**
+ *  @name Constructors
+ */
+///@{
+
+/// Default constructor. The matrix is empty (0 x 0).
+matrix::matrix() : rows_(0), cols_(0) {}
+
+/// Construct a `rows` x `cols` matrix of zeros.
+matrix::matrix(size_t rows, size_t cols)
+    : rows_(rows), cols_(cols), data_(rows * cols) {}
+
+/// Construct a matrix from a list of rows, e.g. `matrix{{1, 2}, {3, 4}}`.
+matrix::matrix(std::initializer_list<std::initializer_list<bi_t>> rows)
+    : rows_(rows.size()), cols_(rows.size() != 0 ? rows.begin()->size() : 0) {
+  data_.reserve(rows_ * cols_);
+  for (const std::initializer_list<bi_t>& row : rows) {
+    if (row.size() != cols_) {
+      throw std::invalid_argument("Rows differ in length.");
+    }
+    data_.insert(data_.end(), row.begin(), row.end());
+  }
+}
+
+/// Return the `n` x `n` identity matrix.
+matrix matrix::identity(size_t n) {
+  matrix result(n, n);
+  for (size_t i = 0; i < n; ++i) {
+    result(i, i) = 1;
+  }
+  return result;
+}
+
+///@}
+
+/**
+ *  @name Accessors
+ */
+///@{
+
+/// Return the number of rows.
+size_t matrix::rows() const noexcept { return rows_; }
+
+/// Return the number of columns.
+size_t matrix::cols() const noexcept { return cols_; }
+
+/// Return the entry in row `i` and column `j`. No bounds checking is done.
+bi_t& matrix::operator()(size_t i, size_t j) { return data_[i * cols_ + j]; }
+
+/// Return the entry in row `i` and column `j`. No bounds checking is done.
+const bi_t& matrix::operator()(size_t i, size_t j) const {
+  return data_[i * cols_ + j];
+}
+
+/// Return the entries of row `i`. No bounds checking is done.
+std::span<bi_t> matrix::row(size_t i) {
+  return std::span<bi_t>(data_).subspan(i * cols_, cols_);
+}
+
+/// Return the entries of row `i`. No bounds checking is done.
+std::span<const bi_t> matrix::row(size_t i) const {
+  return std::span<const bi_t>(data_).subspan(i * cols_, cols_);
+}
+
+///@}
+
+/**
+ *  @name Unary operators
+ */
+///@{
+
+matrix matrix::operator+() const { return *this; }
+
+matrix matrix::operator-() const {
+  matrix ret(*this);
+  for (bi_t& entry : ret.data_) {
+    entry.negate();
+  }
+  return ret;
+}
+
+///@}
+
+/**
+ *  @name Arithmetic operators
+ */
+///@{
+
+matrix matrix::operator+(const matrix& other) const {
+  matrix ret(*this);
+  ret += other;
+  return ret;
+}
+
+matrix matrix::operator-(const matrix& other) const {
+  matrix ret(*this);
+  ret -= other;
+  return ret;
+}
+
+/**
+ *  @complexity \f$ O(n^{\log_{2}(7)}) \f$ entry products for \f$ n \times n
+ *  \f$ matrices above the Strassen threshold, \f$ O(n^{3}) \f$ otherwise.
+ */
+matrix matrix::operator*(const matrix& other) const {
+  if (cols_ != other.rows_) {
+    throw std::invalid_argument("Matrix dimensions do not match.");
+  }
+  return mul_strassen(*this, other);
+}
+
+matrix& matrix::operator+=(const matrix& other) {
+  if (rows_ != other.rows_ || cols_ != other.cols_) {
+    throw std::invalid_argument("Matrix dimensions do not match.");
+  }
+  for (size_t i = 0; i < data_.size(); ++i) {
+    data_[i] += other.data_[i];
+  }
+  return *this;
+}
+
+matrix& matrix::operator-=(const matrix& other) {
+  if (rows_ != other.rows_ || cols_ != other.cols_) {
+    throw std::invalid_argument("Matrix dimensions do not match.");
+  }
+  for (size_t i = 0; i < data_.size(); ++i) {
+    data_[i] -= other.data_[i];
+  }
+  return *this;
+}
+
+matrix& matrix::operator*=(const matrix& other) {
+  *this = *this * other;
+  return *this;
+}
+
+///@}
+
+/**
+ *  @name Comparisons
+ */
+///@{
+
+bool matrix::operator==(const matrix& other) const {
+  return rows_ == other.rows_ && cols_ == other.cols_ && data_ == other.data_;
+}
+
+///@}
+
+/**
+ *  @name Other
+ */
+///@{
+
+/**
+ *  @brief Swap the contents of this matrix with `other`.
+ *  @complexity O(1)
+ */
+void matrix::swap(matrix& other) noexcept {
+  std::swap(rows_, other.rows_);
+  std::swap(cols_, other.cols_);
+  data_.swap(other.data_);
+}
+
+///@}
+
+/**
+ *  @brief Write the matrix to the output stream `os` as a list of rows, e.g.
+ *  `[[1, 2], [3, 4]]`.
+ *  @relates matrix
+ */
+std::ostream& operator<<(std::ostream& os, const matrix& x) {
+  os << '[';
+  for (size_t i = 0; i < x.rows(); ++i) {
+    os << (i != 0 ? ", [" : "[");
+    for (size_t j = 0; j < x.cols(); ++j) {
+      os << (j != 0 ? ", " : "") << x(i, j);
+    }
+    os << ']';
+  }
+  return os << ']';
+}
+
+/**
+ *  @brief Swap the contents of `a` with `b`.
+ *  @relates matrix
+ *  @complexity O(1)
+ */
+void swap(matrix& a, matrix& b) noexcept { a.swap(b); }
+
+}  // namespace bi
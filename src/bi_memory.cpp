@@ -0,0 +1,149 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#include "bi_memory.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace bi {
+
+namespace {
+
+// The fields of the current allocation_policy
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<size_t> threshold{allocation_policy{}.huge_page_threshold};
+std::atomic<bool> explicit_pages{allocation_policy{}.explicit_huge_pages};
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+#if defined(__linux__)
+// Huge pages are assumed to be 2 MiB, the size on x86-64 and usually on
+// AArch64
+constexpr size_t huge_page_size = size_t{2} << 20;
+
+/// Return `bytes` rounded up to a multiple of the huge page size.
+size_t mapped_length(size_t bytes) noexcept {
+  return (bytes + (huge_page_size - 1)) & ~(huge_page_size - 1);
+}
+
+/**
+ *  Map `length` bytes, a multiple of the huge page size, backed by huge pages
+ *  if possible. Return null on failure.
+ */
+void* map_huge(size_t length, bool hugetlb) noexcept {
+  constexpr int protection = PROT_READ | PROT_WRITE;
+  constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+  if (hugetlb) {
+    // Fails unless enough 2 MiB pages are reserved; transparent huge pages
+    // serve as the fallback
+    constexpr int huge_2mb = 21 << MAP_HUGE_SHIFT;
+    void* p = mmap(nullptr, length, protection, flags | MAP_HUGETLB | huge_2mb,
+                   -1, 0);
+    if (p != MAP_FAILED) {
+      return p;
+    }
+  }
+#endif
+
+  // Map one huge page more than needed and trim the mapping to a huge page
+  // boundary, so that every page of the array can be a huge page
+  if (length > SIZE_MAX - huge_page_size) {
+    return nullptr;
+  }
+  void* raw = mmap(nullptr, length + huge_page_size, protection, flags, -1, 0);
+  if (raw == MAP_FAILED) {
+    return nullptr;
+  }
+  const auto begin = reinterpret_cast<uintptr_t>(raw);  // NOLINT
+  const uintptr_t aligned =
+      (begin + (huge_page_size - 1)) & ~uintptr_t{huge_page_size - 1};
+  if (aligned != begin) {
+    munmap(raw, aligned - begin);
+  }
+  // NOLINTNEXTLINE(performance-no-int-to-ptr)
+  void* p = reinterpret_cast<void*>(aligned);
+  munmap(static_cast<char*>(p) + length, huge_page_size - (aligned - begin));
+
+#if defined(MADV_HUGEPAGE)
+  // Advisory only: without transparent huge pages, the mapping still works
+  madvise(p, length, MADV_HUGEPAGE);
+#endif
+  return p;
+}
+#endif
+
+}  // namespace
+
+namespace memory {
+
+/**
+ *  Return uninitialized storage of `bytes` bytes, setting `mapped` if it is
+ *  backed by huge pages and must be freed with `unmap()`, and clearing it if it
+ *  comes from `operator new`.
+ */
+void* allocate(size_t bytes, bool& mapped) {
+  mapped = false;
+#if defined(__linux__)
+  if (bytes != 0 && bytes >= threshold.load(std::memory_order_relaxed)) {
+    if (void* p = map_huge(mapped_length(bytes),
+                           explicit_pages.load(std::memory_order_relaxed))) {
+      mapped = true;
+      return p;
+    }
+  }
+#endif
+  return ::operator new(bytes);
+}
+
+/// Free storage of `bytes` bytes that `allocate()` mapped.
+void unmap([[maybe_unused]] void* p, [[maybe_unused]] size_t bytes) noexcept {
+#if defined(__linux__)
+  munmap(p, mapped_length(bytes));
+#endif
+}
+
+}  // namespace memory
+
+/**
+ *  @struct allocation_policy
+ *  @headerfile "bi_memory.hpp"
+ *  @brief How the digit arrays of integers are allocated.
+ *
+ *  Arrays of fewer than `huge_page_threshold` bytes come from `operator new`.
+ *  On Linux, larger ones are mapped with `mmap()` on a 2 MiB boundary and
+ *  marked with `madvise(MADV_HUGEPAGE)`, so that the kernel backs them with
+ *  transparent huge pages. This cuts TLB misses in the loops over integers of
+ *  millions of digits. With `explicit_huge_pages`, they are instead mapped
+ *  with `MAP_HUGETLB` from the 2 MiB pages reserved through
+ *  `/proc/sys/vm/nr_hugepages`, falling back to transparent huge pages when
+ *  none are left. Elsewhere, all arrays come from `operator new`.
+ *
+ *  The default threshold is 8 MiB. `SIZE_MAX` turns huge pages off.
+ */
+
+/// Return the policy that allocations of digit arrays follow.
+allocation_policy get_allocation_policy() noexcept {
+  return {threshold.load(), explicit_pages.load()};
+}
+
+/**
+ *  @brief Set the policy that allocations of digit arrays follow.
+ *  @details The policy applies to arrays allocated from then on, by any
+ *  thread. Arrays allocated under an earlier policy are freed the way they
+ *  were allocated.
+ */
+void set_allocation_policy(const allocation_policy& policy) noexcept {
+  threshold = policy.huge_page_threshold;
+  explicit_pages = policy.explicit_huge_pages;
+}
+
+}  // namespace bi
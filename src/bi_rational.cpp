@@ -0,0 +1,437 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#include "bi_rational.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "bi_exceptions.hpp"
+
+namespace bi {
+
+/**
+ *  @class rational
+ *  @headerfile "bi_rational.hpp"
+ *  @brief Arbitrary-precision rational number type built on `bi_t`.
+ *
+ *  An instance of `rational` represents the quotient of a `bi_t` numerator and
+ *  a positive `bi_t` denominator.
+ *
+ *  Reducing a fraction to lowest terms requires a gcd computation, which
+ *  usually dominates the cost of an operation. A `rational` is therefore only
+ *  *lazily* normalized: operations keep track of whether their result is known
+ *  to be in lowest terms and only reduce when the canonical form is actually
+ *  needed (e.g. by `normalize()` or `to_string()`). In particular:
+ *  - Addition and subtraction of values with equal denominators only add or
+ *    subtract the numerators.
+ *  - Multiplication and division cross-cancel, i.e. compute
+ *    \f$ \gcd(a, d) \f$ and \f$ \gcd(c, b) \f$ for \f$ (a/b)(c/d) \f$, which
+ *    keeps the intermediate products small and yields a result in lowest terms
+ *    whenever the operands are.
+ *  - Divisions by a gcd are exact and use `divexact()`.
+ *  - Comparisons decide most cases from signs and bit lengths, and only fall
+ *    back to comparing the cross products \f$ ad \f$ and \f$ cb \f$.
+ *
+ *  The value of a `rational` never depends on whether it is normalized, so
+ *  comparisons and conversions do not require a prior call to `normalize()`.
+ *  However, `numerator()` and `denominator()` return the stored, possibly
+ *  unreduced, components.
+ *
+ *  @throw std::bad_alloc Throws in case of memory allocation failure.
+ *  @throw bi::division_by_zero Throws if a zero denominator is provided or if a
+ *  division by zero attempt is detected.
+ */
+
+/**
+ *  @name Constructors
+ */
+///@{
+
+/// Default constructor. The number is initialized to zero.
+rational::rational() : den_(1), normalized_(true) {}
+
+/// Construct the rational number `num / 1`.
+rational::rational(const bi_t& num) : num_(num), den_(1), normalized_(true) {}
+
+/**
+ *  @brief Construct the rational number `num / den`. The fraction is not
+ *  reduced to lowest terms.
+ *  @throw bi::division_by_zero Throws if `den` is zero.
+ */
+rational::rational(const bi_t& num, const bi_t& den)
+    : num_(num), den_(den), normalized_(false) {
+  if (den_.sign() == 0) {
+    throw division_by_zero("Zero denominator provided.");
+  }
+  if (den_.negative()) {
+    num_.negate();
+    den_.negate();
+  }
+  normalized_ = den_ == 1;
+}
+
+/**
+ *  @brief Construct a rational number with exactly the value of `d`.
+ *  @throw bi::from_float Throws if `d` is a NaN or infinity.
+ */
+rational::rational(double d) : den_(1), normalized_(true) {
+  if (d == 0) {
+    return;
+  }
+
+  constexpr int mant_dig = std::numeric_limits<double>::digits;
+
+  int exp = 0;
+  const double frac = std::frexp(d, &exp);
+  // Exact, since the significand of a double has `mant_dig` bits
+  num_ = std::ldexp(frac, mant_dig);
+  exp -= mant_dig;
+
+  if (exp >= 0) {
+    num_ <<= static_cast<bi_bitcount_t>(exp);
+    return;
+  }
+
+  while (exp < 0 && num_.even()) {
+    num_ >>= 1;
+    ++exp;
+  }
+  den_ <<= static_cast<bi_bitcount_t>(-exp);
+}
+
+/**
+ *  @brief Construct a rational number from a string of the form `"n"` or
+ *  `"n/d"`, where `n` and `d` are base-10 integers as accepted by
+ *  `bi_t(const std::string&)`.
+ *  @throw std::invalid_argument Throws if a parsing error occurs.
+ *  @throw bi::division_by_zero Throws if `d` is zero.
+ */
+rational::rational(const std::string& s) : den_(1), normalized_(true) {
+  const size_t pos = s.find('/');
+  if (pos == std::string::npos) {
+    num_ = bi_t(s);
+    return;
+  }
+
+  *this = rational(bi_t(s.substr(0, pos)), bi_t(s.substr(pos + 1)));
+}
+
+///@}
+
+/**
+ *  @name Accessors
+ */
+///@{
+
+/// Return the stored numerator, which carries the sign of the number.
+const bi_t& rational::numerator() const noexcept { return num_; }
+
+/// Return the stored denominator, which is always positive.
+const bi_t& rational::denominator() const noexcept { return den_; }
+
+/// Return `true` if the number is known to be in lowest terms.
+bool rational::normalized() const noexcept { return normalized_; }
+
+/**
+ *  @brief Reduce the fraction to lowest terms, if not already known to be in
+ *  lowest terms. Zero is represented as `0 / 1`.
+ */
+rational& rational::normalize() {
+  if (normalized_) {
+    return *this;
+  }
+
+  const bi_t g = gcd(num_, den_);
+  if (g != 1) {
+    num_ = divexact(num_, g);
+    den_ = divexact(den_, g);
+  }
+  normalized_ = true;
+
+  return *this;
+}
+
+///@}
+
+/**
+ *  @name Unary operators
+ */
+///@{
+
+rational rational::operator+() const { return *this; }
+
+rational rational::operator-() const {
+  rational ret(*this);
+  ret.num_.negate();
+  return ret;
+}
+
+///@}
+
+/**
+ *  @name Arithmetic operators
+ *  @throw bi::division_by_zero Throws if a division by zero attempt is
+ *  detected.
+ */
+///@{
+
+rational rational::operator+(const rational& other) const {
+  rational ret(*this);
+  ret.add_(other, false);
+  return ret;
+}
+
+rational rational::operator-(const rational& other) const {
+  rational ret(*this);
+  ret.add_(other, true);
+  return ret;
+}
+
+rational rational::operator*(const rational& other) const {
+  rational ret(*this);
+  ret *= other;
+  return ret;
+}
+
+rational rational::operator/(const rational& other) const {
+  rational ret(*this);
+  ret /= other;
+  return ret;
+}
+
+rational& rational::operator+=(const rational& other) {
+  return add_(other, false);
+}
+
+rational& rational::operator-=(const rational& other) {
+  return add_(other, true);
+}
+
+rational& rational::operator*=(const rational& other) {
+  if (this == &other) {
+    // Squaring preserves lowest terms
+    num_ *= num_;
+    den_ *= den_;
+    return *this;
+  }
+
+  bi_t other_num = other.num_;
+  bi_t other_den = other.den_;
+
+  // Cross-cancel: (a/b)(c/d) = ((a/g1)(c/g2)) / ((b/g2)(d/g1))
+  if (other_den != 1) {
+    const bi_t g1 = gcd(num_, other_den);
+    if (g1 != 1) {
+      num_ = divexact(num_, g1);
+      other_den = divexact(other_den, g1);
+    }
+  }
+  if (den_ != 1) {
+    const bi_t g2 = gcd(other_num, den_);
+    if (g2 != 1) {
+      other_num = divexact(other_num, g2);
+      den_ = divexact(den_, g2);
+    }
+  }
+
+  num_ *= other_num;
+  den_ *= other_den;
+  normalized_ = normalized_ && other.normalized_;
+
+  return *this;
+}
+
+rational& rational::operator/=(const rational& other) {
+  if (other.num_.sign() == 0) {
+    throw division_by_zero("Division by zero attempt.");
+  }
+
+  rational reciprocal;
+  reciprocal.num_ = other.den_;
+  reciprocal.den_ = other.num_;
+  reciprocal.normalized_ = other.normalized_;
+  if (reciprocal.den_.negative()) {
+    reciprocal.num_.negate();
+    reciprocal.den_.negate();
+  }
+
+  return *this *= reciprocal;
+}
+
+///@}
+
+/**
+ *  @name Comparisons
+ */
+///@{
+
+std::strong_ordering rational::operator<=>(const rational& other) const {
+  const int s = num_.sign();
+  const int t = other.num_.sign();
+  if (s != t || s == 0) {
+    return s <=> t;
+  }
+
+  if (den_ == other.den_) {
+    return num_ <=> other.num_;
+  }
+
+  // Compare a/b with c/d via |a| * d and |c| * b. A product of integers with
+  // bit lengths x and y has bit length x + y - 1 or x + y, so the cross
+  // products only need to be formed when their bit length sums are close.
+  const bi_bitcount_t lhs_bits = num_.bit_length() + other.den_.bit_length();
+  const bi_bitcount_t rhs_bits = other.num_.bit_length() + den_.bit_length();
+  if (lhs_bits > rhs_bits + 1) {
+    return s > 0 ? std::strong_ordering::greater : std::strong_ordering::less;
+  }
+  if (rhs_bits > lhs_bits + 1) {
+    return s > 0 ? std::strong_ordering::less : std::strong_ordering::greater;
+  }
+
+  return num_ * other.den_ <=> other.num_ * den_;
+}
+
+bool rational::operator==(const rational& other) const {
+  if (normalized_ && other.normalized_) {
+    return num_ == other.num_ && den_ == other.den_;
+  }
+  return (*this <=> other) == 0;
+}
+
+///@}
+
+/**
+ *  @brief Return the nearest `double` to the value of the number, with ties
+ *  rounded to even. The result is correctly rounded unless it is subnormal.
+ *  Values too large in magnitude to be represented convert to an infinity.
+ */
+rational::operator double() const {
+  if (num_.sign() == 0) {
+    return 0.0;
+  }
+
+  bi_t a = abs(num_);
+  bi_t b = den_;
+
+  // Scale so that q = floor(|a| * 2^{shift} / b) is in [2^63, 2^65)
+  const int64_t shift = 64 - static_cast<int64_t>(a.bit_length()) +
+                        static_cast<int64_t>(b.bit_length());
+  if (shift >= 0) {
+    a <<= static_cast<bi_bitcount_t>(shift);
+  } else {
+    b <<= static_cast<bi_bitcount_t>(-shift);
+  }
+
+  auto [q, r] = a.div(b);
+  bool sticky = r.sign() != 0;
+  int64_t exp = -shift;
+  if (q.bit_length() > 64) {
+    sticky = sticky || q.odd();
+    q >>= 1;
+    ++exp;
+  }
+
+  // The 11 bits below the 53 significant bits of q absorb the sticky bit, so
+  // the conversion of the 64-bit value rounds correctly
+  const auto m = static_cast<uint64_t>(q) | static_cast<uint64_t>(sticky);
+  const double result = std::ldexp(static_cast<double>(m),
+                                   static_cast<int>(std::clamp<int64_t>(
+                                       exp, INT16_MIN, INT16_MAX)));
+
+  return num_.negative() ? -result : result;
+}
+
+///@}
+
+/**
+ *  @name Other
+ */
+///@{
+
+/**
+ *  @brief Swap the contents of this number with `other`.
+ *  @complexity O(1)
+ */
+void rational::swap(rational& other) noexcept {
+  num_.swap(other.num_);
+  den_.swap(other.den_);
+  std::swap(normalized_, other.normalized_);
+}
+
+/**
+ *  @brief Return the number in lowest terms as a base-10 string of the form
+ *  `"n/d"`, or `"n"` if the denominator is 1.
+ */
+std::string rational::to_string() const {
+  if (!normalized_) {
+    rational reduced(*this);
+    return reduced.normalize().to_string();
+  }
+
+  if (den_ == 1) {
+    return num_.to_string();
+  }
+  return num_.to_string() + "/" + den_.to_string();
+}
+
+/// Return -1 if the number is negative, 0 if it is zero, and 1 otherwise.
+int rational::sign() const noexcept { return num_.sign(); }
+
+///@}
+
+/// Add `other` to (or subtract it from) this number in place.
+rational& rational::add_(const rational& other, bool subtract) {
+  if (den_ == other.den_) {
+    // A common factor may appear unless the denominator is 1
+    if (subtract) {
+      num_ -= other.num_;
+    } else {
+      num_ += other.num_;
+    }
+    normalized_ = den_ == 1;
+    return *this;
+  }
+
+  // a/1 +- c/d = (ad +- c)/d is in lowest terms if c/d is, since
+  // gcd(ad +- c, d) = gcd(c, d)
+  const bool keep_normalized = (den_ == 1 && other.normalized_) ||
+                               (other.den_ == 1 && normalized_);
+
+  const bi_t cross = other.num_ * den_;
+  num_ *= other.den_;
+  if (subtract) {
+    num_ -= cross;
+  } else {
+    num_ += cross;
+  }
+  den_ *= other.den_;
+  normalized_ = keep_normalized;
+
+  return *this;
+}
+
+/**
+ *  @brief Write the number in lowest terms to the output stream `os`.
+ *  @relates rational
+ */
+std::ostream& operator<<(std::ostream& os, const rational& x) {
+  return os << x.to_string();
+}
+
+/**
+ *  @brief Swap the contents of `a` with `b`.
+ *  @relates rational
+ *  @complexity O(1)
+ */
+void swap(rational& a, rational& b) noexcept { a.swap(b); }
+
+}  // namespace bi
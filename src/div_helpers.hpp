@@ -0,0 +1,65 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef BI_SRC_DIV_HELPERS_HPP_
+#define BI_SRC_DIV_HELPERS_HPP_
+
+#include <utility>
+
+#include "constants.hpp"
+#include "mult_helpers.hpp"
+#include "uints.hpp"
+
+namespace bi {
+
+/**
+ *  @brief Precomputed reciprocal of a single-digit divisor, for division
+ *  without hardware division instructions (Möller and Granlund, "Improved
+ *  division by invariant integers", 2011).
+ */
+struct digit_reciprocal {
+  // Divisor shifted left so that its most significant bit is set
+  digit d;
+  // floor((B^2 - 1) / d) - B, where B = bi_base
+  digit v;
+  // Number of bits the original divisor was shifted left by
+  unsigned shift;
+};
+
+/// Return the reciprocal of the nonzero digit `d`.
+constexpr digit_reciprocal make_reciprocal(digit d) noexcept {
+  const unsigned shift = uints::clz(d);
+  const digit d_norm = d << shift;
+  // (B^2 - 1) - B * d_norm = (B - 1 - d_norm) * B + (B - 1)
+  const ddigit num = (static_cast<ddigit>(~d_norm) << bi_dwidth) | bi_dmax;
+  return {d_norm, static_cast<digit>(num / d_norm), shift};
+}
+
+/**
+ *  @brief Return the quotient and remainder of `(u1 * B + u0) / inv.d`, where
+ *  `u1 < inv.d`. Costs two multiplications in place of a double-width division.
+ */
+constexpr std::pair<digit, digit> div_2by1(
+    digit u1, digit u0, const digit_reciprocal& inv) noexcept {
+  auto [q1, q0] = mult_helpers::mult2(inv.v, u1);
+  q0 += u0;
+  q1 += u1 + 1 + static_cast<digit>(q0 < u0);
+
+  digit r = u0 - q1 * inv.d;
+  if (r > q0) {
+    --q1;
+    r += inv.d;
+  }
+  if (r >= inv.d) {
+    ++q1;
+    r -= inv.d;
+  }
+
+  return {q1, r};
+}
+
+}  // namespace bi
+
+#endif  // BI_SRC_DIV_HELPERS_HPP_
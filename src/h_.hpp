@@ -8,17 +8,27 @@ SPDX-License-Identifier: Apache-2.0
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cassert>
 #include <cmath>
+#include <concepts>
 #include <limits>
 #include <random>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "bi.hpp"
 #include "bi.inl"
 #include "bi_exceptions.hpp"
 #include "constants.hpp"
+#include "div_helpers.hpp"
+#include "parallel.hpp"
+#include "power_cache.hpp"
+#include "rounding.hpp"
 #include "uints.hpp"
 
 /// @defgroup algorithms Algorithms
@@ -44,18 +54,51 @@ struct h_ {
   static void mul_algo_knuth(bi_t& result, const bi_t& a, const bi_t& b,
                              const size_t m, const size_t n);
   static void mul_karatsuba(bi_t& result, const bi_t& a, const bi_t& b);
+  static void mul_karatsuba_parallel(bi_t& result, const bi_t& a,
+                                     const bi_t& b, size_t n);
   static void mul_standard(bi_t& result, const bi_t& a, const bi_t& b);
   static void mul(bi_t& result, const bi_t& a, const bi_t& b);
+  static void assign_digits(bi_t& x, std::span<const digit> digits);
+  static void add_shifted(bi_t& acc, std::span<const digit> x, size_t shift);
+  static void mul_low_standard(bi_t& acc, std::span<const digit> a,
+                               std::span<const digit> b, size_t offset);
+  static void mul_low_acc(bi_t& acc, std::span<const digit> a,
+                          std::span<const digit> b, size_t offset);
+  static void mul_low(bi_t& result, const bi_t& a, const bi_t& b, size_t n);
+  static void mul_high_standard(bi_t& acc, std::span<const digit> a,
+                                std::span<const digit> b, size_t t,
+                                size_t offset);
+  static void mul_high_acc(bi_t& acc, std::span<const digit> a,
+                           std::span<const digit> b, size_t t, size_t offset);
+  static void mul_high(bi_t& result, const bi_t& a, const bi_t& b, size_t n);
+  static void addmul(bi_t& acc, const bi_t& a, const bi_t& b, bool subtract);
+  static void poly_pack(bi_t& x, std::span<const bi_t> coeffs, size_t slot);
+  static void poly_unpack(std::vector<bi_t>& coeffs, const bi_t& x, size_t slot,
+                          size_t count);
+  static void poly_mul(std::vector<bi_t>& result, std::span<const bi_t> a,
+                       std::span<const bi_t> b);
   static digit div_algo_digit(bi_t& q, const bi_t& u, digit v) noexcept;
-  static void div_algo_single(bi_t& q, bi_t& r, const bi_t& n,
-                              const bi_t& d) noexcept;
+  static digit div_algo_digit(bi_t& q, const bi_t& u,
+                              const digit_reciprocal& inv) noexcept;
+  static digit rem_algo_digit(const bi_t& u,
+                              const digit_reciprocal& inv) noexcept;
   static void div_algo_binary(bi_t& q, bi_t& r, const bi_t& n, const bi_t& d);
-  static void div_algo_knuth(bi_t& q, bi_t& r, const bi_t& n, const bi_t& d);
+  static void div_algo_knuth(bi_t& w, const bi_t& v);
+  static void assign_reserve(bi_t& x, const bi_t& value, size_t capacity);
+  static bool div_small(const bi_t& n, const bi_t& d) noexcept;
   static void divide(bi_t& q, bi_t& r, const bi_t& n, const bi_t& d);
+  static bool div_inplace(bi_t& x, const bi_t& d, bool remainder);
+  static void quot_away_from_zero(bi_t& q, bool negative);
+  static void rem_complement(bi_t& r, const bi_t& d, bool negative);
+  static void divexact(bi_t& q, const bi_t& n, const bi_t& d);
 
   // bits
   static void left_shift(bi_t& result, const bi_t& a, bi_bitcount_t shift);
   static void right_shift(bi_t& result, const bi_t& a, bi_bitcount_t shift);
+  static void right_shift_trunc(bi_t& result, const bi_t& a,
+                                bi_bitcount_t shift);
+  static void low_bits(bi_t& result, const bi_t& a, bi_bitcount_t count);
+  static bool is_pow2_abs(const bi_t& x) noexcept;
   enum class BitwiseOperation { AND, OR, XOR };
   template <BitwiseOperation Op>
   static void bitwise_operation_impl(bi_t& res, const bi_t& a, const bi_t& b);
@@ -81,6 +124,10 @@ struct h_ {
   static void init_atleast_one_digit(bi_t& x, T value);
   // NOLINTNEXTLINE
   static void init_string(bi_t& x, const std::string& str, int base = 10);
+  static void parse_digits(bi_t& x, std::string::const_iterator first,
+                           std::string::const_iterator last, int base);
+  static void format_digits(std::string& out, bi_t& x, int base,
+                            size_t width);
 
   // misc.
   static dvector to_twos_complement(const dvector& vec);
@@ -88,7 +135,13 @@ struct h_ {
   static void bisect(const bi_t&, bi_t&, bi_t&, size_t m);
 
   // double
-  static void assign_from_double(bi_t&, double);
+  template <std::floating_point F>
+  static void assign_from_floating(bi_t&, F);
+  static digit bits_at(const bi_t& x, bi_bitcount_t pos,
+                       unsigned count) noexcept;
+  static bool any_bit_below(const bi_t& x, bi_bitcount_t pos) noexcept;
+  template <std::floating_point F>
+  static F to_floating(const bi_t& x, rounding mode) noexcept;
   static int cmp_abs(const bi_t&, double) noexcept;
   static int cmp(const bi_t&, double) noexcept;
 
@@ -96,6 +149,23 @@ struct h_ {
   template <std::unsigned_integral T>
   static bi_t expo_left_to_right(const bi_t& base, T exp);
 
+  // greatest common divisor
+  static digit top_bits(const bi_t& x, bi_bitcount_t shift) noexcept;
+  static void lehmer_update(bi_t& u, bi_t& v, sddigit a, sddigit b, sddigit c,
+                            sddigit d);
+  static void gcd(bi_t& result, const bi_t& a, const bi_t& b);
+
+  // number theory
+  static bi_bitcount_t trailing_zeros(const bi_t& x) noexcept;
+  static void mulmod(bi_t& result, const bi_t& a, const bi_t& b,
+                     const bi_t& m);
+  static void powmod(bi_t& result, const bi_t& base, const bi_t& exp,
+                     const bi_t& m);
+  static int jacobi_digit(digit a, digit n, int s) noexcept;
+  static int jacobi(const bi_t& a, const bi_t& n);
+  static int kronecker(const bi_t& a, const bi_t& n);
+  static void sqrtmod(bi_t& result, const bi_t& a, const bi_t& p);
+
   // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
   static thread_local std::mt19937 rng_;
   static bi_t random_(bi_bitcount_t z);
@@ -225,25 +295,24 @@ void h_::add_abs(bi_t& r, const bi_t& x, const bi_t& y) {
   // Algorithm assumes x.size() >= y.size()
   const bi_t& large = x.size() >= y.size() ? x : y;
   const bi_t& small = x.size() >= y.size() ? y : x;
+  const size_t m = large.size();
+  const size_t n = small.size();
 
-  r.reserve_(large.size() + 1);
+  r.reserve_(m + 1);
 
-  digit temp{};
-  bool carry = 0;
-  size_t i = 0;
-  for (; i < small.size(); ++i) {
-    uints::uaddc(temp, large[i], small[i], carry);
-    r[i] = temp;
-  }
+  // After reserve_(), which may reallocate the digits of r (and so of an
+  // aliased operand)
+  digit* rd = r.vec_.data();
+  const digit* ld = large.vec_.data();
+  const digit* sd = small.vec_.data();
 
-  while (i < large.size()) {
-    temp = large[i] + carry;
-    carry = temp < static_cast<uint8_t>(carry);  // MSVC warning C4804
-    r[i++] = temp;
-  }
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  digit carry = uints::add_n(rd, ld, sd, n);
+  carry = uints::add_1(rd + n, ld + n, m - n, carry);
+  rd[m] = carry;
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
 
-  r[i] = carry;
-  r.resize_(large.size() + 1);
+  r.resize_(m + 1);
   r.trim();
   r.negative_ = false;
 }
@@ -273,23 +342,21 @@ void h_::add(bi_t& r, const bi_t& x, const bi_t& y) {
 /// |x| - |y|, assuming |x| > |y|.
 void h_::sub_abs_gt(bi_t& r, const bi_t& x, const bi_t& y) {
   assert(x.size() >= y.size());
+  const size_t m = x.size();
+  const size_t n = y.size();
 
-  r.reserve_(x.size());
+  r.reserve_(m);
 
-  digit temp{};
-  bool borrow = 0;
-  size_t i = 0;
-  for (; i < y.size(); ++i) {
-    uints::usubb(temp, x[i], y[i], borrow);
-    r[i] = temp;
-  }
-  while (i < x.size()) {
-    temp = x[i] - borrow;
-    borrow = temp > x[i];
-    r[i++] = temp;
-  }
+  digit* rd = r.vec_.data();
+  const digit* xd = x.vec_.data();
+  const digit* yd = y.vec_.data();
+
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  const digit borrow = uints::sub_n(rd, xd, yd, n);
+  uints::sub_1(rd + n, xd + n, m - n, borrow);
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
 
-  r.resize_(x.size());
+  r.resize_(m);
   r.trim();
   r.negative_ = false;
 }
@@ -507,6 +574,12 @@ void h_::bisect(const bi::bi_t& x, bi::bi_t& lower, bi::bi_t& upper, size_t n) {
 void h_::mul_karatsuba(bi_t& w, const bi_t& u, const bi_t& v) {
   const size_t n = std::min(u.size(), v.size()) >> 1;
 
+  if (2 * n >= parallel_digits_threshold && parallel::max_threads() > 1 &&
+      !parallel::in_parallel_region()) {
+    mul_karatsuba_parallel(w, u, v, n);
+    return;
+  }
+
   bi_t u0, u1, v0, v1;
   bisect(u, u0, u1, n);
   bisect(v, v0, v1, n);
@@ -525,6 +598,54 @@ void h_::mul_karatsuba(bi_t& w, const bi_t& u, const bi_t& v) {
   w = a + c + b;  // w = (bi_base ** 2n) * a + (bi_base ** n) * c + b
 }
 
+/**
+ *  @brief `mul_karatsuba()` with the three products of the halves of `u` and
+ *  `v`, split at digit `n`, computed in parallel.
+ *  @details Each product copies the halves it needs and allocates its result
+ *  on the thread that computes it. Since the threads of a parallel loop run on
+ *  the NUMA nodes in turn, and memory is placed on the node that first touches
+ *  it, the operands and results of each product are local to the thread that
+ *  works on them. The products themselves recurse serially.
+ */
+void h_::mul_karatsuba_parallel(bi_t& w, const bi_t& u, const bi_t& v,
+                                size_t n) {
+  const std::span<const digit> u_digits = u.digits();
+  const std::span<const digit> v_digits = v.digits();
+
+  std::array<bi_t, 3> p;
+  parallel::for_each_index(
+      p.size(),
+      [&](size_t i) {
+        bi_t x, y;
+        if (i == 0) {
+          assign_digits(x, u_digits.subspan(n));
+          assign_digits(y, v_digits.subspan(n));
+        } else if (i == 1) {
+          assign_digits(x, u_digits.first(n));
+          assign_digits(y, v_digits.first(n));
+        } else {
+          bi_t low;
+          assign_digits(x, u_digits.subspan(n));
+          assign_digits(low, u_digits.first(n));
+          x += low;
+          assign_digits(y, v_digits.subspan(n));
+          assign_digits(low, v_digits.first(n));
+          y += low;
+        }
+        mul(p[i], x, y);
+      },
+      p.size());
+
+  bi_t& a = p[0];  // u1 * v1
+  bi_t& b = p[1];  // u0 * v0
+  bi_t& c = p[2];  // (u1 + u0)(v1 + v0)
+  c -= a + b;
+
+  a <<= (2 * n * bi_dbits);
+  c <<= (n * bi_dbits);
+  w = a + c + b;
+}
+
 /**
  *  @brief Performs `result = |a| * |b|`.
  *  @note mult_helpers.hpp proves that multiplying any two digits followed by
@@ -563,13 +684,462 @@ void h_::mul_standard(bi_t& result, const bi_t& a, const bi_t& b) {
 }
 
 void h_::mul(bi_t& w, const bi_t& u, const bi_t& v) {
-  if (u.size() < karatsuba_threshold || v.size() < karatsuba_threshold) {
+  // Before the multiplication, since w may alias u or v
+  const bool result_negative = u.negative() != v.negative();
+
+  // A power of two only shifts the other factor
+  if (is_pow2_abs(v)) {
+    left_shift(w, u, v.bit_length() - 1);
+  } else if (is_pow2_abs(u)) {
+    left_shift(w, v, u.bit_length() - 1);
+  } else if (u.size() < karatsuba_threshold || v.size() < karatsuba_threshold) {
     h_::mul_standard(w, u, v);
   } else {
     h_::mul_karatsuba(w, u, v);
   }
 
-  w.negative_ = u.negative() != v.negative();
+  w.negative_ = result_negative && w.size() != 0;
+}
+
+/**
+ *  @internal
+ *  @page mul_short Multiplication - Short Products
+ *  @ingroup algorithms
+ *  A short product computes only part of the digits of \f$ uv \f$, where
+ *  \f$ u = (u_{m-1} \ldots u_{0})_{b} \f$ and
+ *  \f$ v = (v_{n-1} \ldots v_{0})_{b} \f$. The low short product
+ *  \f$ uv \bmod b^{k} \f$ is exact and needs only the partial products
+ *  \f$ u_{i}v_{j} \f$ with \f$ i + j < k \f$. The high short product needs
+ *  the partial products with \f$ i + j \geq c \f$ for some cutoff column
+ *  \f$ c \f$; the carries out of the discarded columns make it approximate.
+ *
+ *  Below the Karatsuba threshold, both are computed as in Algorithm M, with
+ *  the rows clipped to the columns that are needed. This does about half of
+ *  the work of a full product when \f$ k \f$ is about half of \f$ m + n \f$.
+ *
+ *  Above the threshold, we follow Mulders ("On short multiplication and
+ *  division", 2000). For the low product with \f$ k \f$ digits, choose
+ *  \f$ \ell \geq k/2 \f$ and write \f$ u = b^{\ell}U_{1} + U_{0} \f$,
+ *  \f$ v = b^{\ell}V_{1} + V_{0} \f$. Then
+ *  \f[
+ *    uv \equiv U_{0}V_{0} + b^{\ell}\left[(U_{1}V_{0} \bmod b^{k-\ell}) +
+ *      (U_{0}V_{1} \bmod b^{k-\ell})\right] \pmod{b^{k}},
+ *  \f]
+ *  where \f$ U_{0}V_{0} \f$ is a full (Karatsuba) product and the other two
+ *  terms are recursive low short products (\f$ U_{1}V_{1} \f$ only affects
+ *  digits \f$ \geq 2\ell \geq k \f$). With \f$ \ell \approx 0.7k \f$ the cost
+ *  is about 80% of a full Karatsuba product.
+ *
+ *  The high product is the mirror image, splitting off the *leading*
+ *  \f$ \ell \f$ digits of each operand. Indexing digits from the top, the
+ *  full product of the leading parts and the two recursive products cover
+ *  disjoint sets of partial products whose union contains every partial
+ *  product in the columns \f$ \geq c \f$. Summing a set of distinct partial
+ *  products that contains all of those columns gives a value \f$ S \f$ with
+ *  \f[
+ *    \sum_{i + j \geq c} u_{i}v_{j}b^{i+j} \leq S \leq uv,
+ *  \f]
+ *  so the error analysis of the clipped schoolbook product applies unchanged.
+ *  With \f$ c = m + n - k - 1 \f$ and
+ *  \f$ h = \lfloor S / b^{m+n-k} \rfloor \f$, the discarded partial products
+ *  sum to less than \f$ \min(m, n) \cdot b^{m+n-k} \f$, so
+ *  \f[
+ *    h \leq \lfloor uv / b^{m+n-k} \rfloor \leq h + \min(m, n).
+ *  \f]
+ *  @endinternal
+ */
+/**
+ *  @private
+ *  @brief Set `x` to the nonnegative integer with the given digits.
+ */
+void h_::assign_digits(bi_t& x, std::span<const digit> digits) {
+  x.vec_ = dvector(digits.begin(), digits.end());
+  x.negative_ = false;
+  x.trim();
+}
+
+/**
+ *  @private
+ *  @brief Performs `acc = (acc + x * bi_base ** shift) mod bi_base **
+ *  acc.size()` on magnitudes. `acc` is not trimmed.
+ */
+void h_::add_shifted(bi_t& acc, std::span<const digit> x, size_t shift) {
+  const size_t size = acc.size();
+  if (shift >= size) {
+    return;
+  }
+  const size_t n = std::min(x.size(), size - shift);
+
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  digit* target = acc.vec_.data() + shift;
+  const digit carry = uints::add_n(target, target, x.data(), n);
+  uints::add_1(target + n, target + n, size - shift - n, carry);
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+/**
+ *  @private
+ *  @brief Adds the low `acc.size() - offset` digits of `|a| * |b|` to `acc`,
+ *  starting at digit `offset`, modulo `bi_base ** acc.size()`. Algorithm M
+ *  with each row clipped to the columns below `acc.size()`.
+ */
+void h_::mul_low_standard(bi_t& acc, std::span<const digit> a,
+                          std::span<const digit> b, size_t offset) {
+  const size_t n = acc.size() - offset;
+
+  for (size_t i = 0; i < std::min(a.size(), n); ++i) {
+    const size_t row = std::min(b.size(), n - i);
+    digit k = 0;
+    for (size_t j = 0; j < row; ++j) {
+      const ddigit t = static_cast<ddigit>(a[i]) * b[j] +
+                       static_cast<ddigit>(acc[offset + i + j]) + k;
+      k = t >> bi_dwidth;                       // floor(t / 2^{bi_dwidth})
+      acc[offset + i + j] = static_cast<digit>(t);  // t mod 2^{bi_dwidth}
+    }
+    for (size_t pos = offset + i + row; k != 0 && pos < acc.size(); ++pos) {
+      const ddigit t = static_cast<ddigit>(acc[pos]) + k;
+      k = t >> bi_dwidth;
+      acc[pos] = static_cast<digit>(t);
+    }
+  }
+}
+
+/// @private Mulders' low short product (see @ref mul_short).
+void h_::mul_low_acc(bi_t& acc, std::span<const digit> a,
+                     std::span<const digit> b, size_t offset) {
+  const size_t n = acc.size() - offset;
+  a = a.first(std::min(a.size(), n));
+  b = b.first(std::min(b.size(), n));
+
+  if (a.size() < karatsuba_threshold || b.size() < karatsuba_threshold) {
+    mul_low_standard(acc, a, b, offset);
+    return;
+  }
+
+  const size_t l = std::max(n - n / 2, n * 7 / 10);
+
+  // U0 * V0, in full
+  bi_t u0, v0, w;
+  assign_digits(u0, a.first(std::min(a.size(), l)));
+  assign_digits(v0, b.first(std::min(b.size(), l)));
+  mul(w, u0, v0);
+  add_shifted(acc, w.vec_, offset);
+
+  if (l >= n) {
+    return;
+  }
+
+  // U1 * V0 and U0 * V1, modulo bi_base ** (n - l)
+  if (a.size() > l) {
+    mul_low_acc(acc, a.subspan(l), b, offset + l);
+  }
+  if (b.size() > l) {
+    mul_low_acc(acc, a, b.subspan(l), offset + l);
+  }
+}
+
+/**
+ *  @brief Performs `result = a * b mod bi_base ** n`, with the sign of `a *
+ *  b`, i.e. the low `n` digits of the product.
+ */
+void h_::mul_low(bi_t& result, const bi_t& a, const bi_t& b, size_t n) {
+  const bool result_negative = a.negative() != b.negative();
+
+  n = std::min(n, a.size() + b.size());
+
+  bi_t acc;
+  acc.resize_(n);
+  std::fill(acc.begin(), acc.end(), 0);
+  mul_low_acc(acc, a.vec_, b.vec_, 0);
+
+  acc.trim();
+  acc.negative_ = result_negative && acc.size() != 0;
+  result.swap(acc);
+}
+
+/**
+ *  @private
+ *  @brief Adds to `acc`, starting at digit `offset`, the partial products
+ *  `a[i] * b[j]` with `(a.size() - 1 - i) + (b.size() - 1 - j) <= t`.
+ */
+void h_::mul_high_standard(bi_t& acc, std::span<const digit> a,
+                           std::span<const digit> b, size_t t, size_t offset) {
+  for (size_t i = 0; i < a.size(); ++i) {
+    const size_t i_top = a.size() - 1 - i;
+    if (i_top > t) {
+      continue;
+    }
+    const size_t j_top = t - i_top;
+    const size_t j_start = b.size() - 1 > j_top ? b.size() - 1 - j_top : 0;
+
+    digit k = 0;
+    for (size_t j = j_start; j < b.size(); ++j) {
+      const ddigit prod = static_cast<ddigit>(a[i]) * b[j] +
+                          static_cast<ddigit>(acc[offset + i + j]) + k;
+      k = prod >> bi_dwidth;
+      acc[offset + i + j] = static_cast<digit>(prod);
+    }
+    for (size_t pos = offset + i + b.size(); k != 0; ++pos) {
+      const ddigit sum = static_cast<ddigit>(acc[pos]) + k;
+      k = sum >> bi_dwidth;
+      acc[pos] = static_cast<digit>(sum);
+    }
+  }
+}
+
+/**
+ *  @private
+ *  @brief Mulders' high short product (see @ref mul_short): adds to `acc` a
+ *  set of distinct partial products of `a` and `b` that includes every one
+ *  that `mul_high_standard()` would add.
+ */
+void h_::mul_high_acc(bi_t& acc, std::span<const digit> a,
+                      std::span<const digit> b, size_t t, size_t offset) {
+  if (a.empty() || b.empty()) {
+    return;
+  }
+
+  if (t >= a.size() + b.size() - 2) {
+    bi_t u, v, w;
+    assign_digits(u, a);
+    assign_digits(v, b);
+    mul(w, u, v);
+    add_shifted(acc, w.vec_, offset);
+    return;
+  }
+
+  if (a.size() < karatsuba_threshold || b.size() < karatsuba_threshold) {
+    mul_high_standard(acc, a, b, t, offset);
+    return;
+  }
+
+  // Counting digits from the top, 2 * l > t: the leading parts' product and
+  // the two recursive products below cover disjoint partial products.
+  const size_t l = std::max(t / 2 + 1, (t + 1) * 7 / 10);
+  const size_t la = std::min(l, a.size());
+  const size_t lb = std::min(l, b.size());
+
+  // U1 * V1, in full
+  bi_t u1, v1, w;
+  assign_digits(u1, a.last(la));
+  assign_digits(v1, b.last(lb));
+  mul(w, u1, v1);
+  add_shifted(acc, w.vec_, offset + (a.size() - la) + (b.size() - lb));
+
+  // U0 * V1 and U1 * V0, restricted to what can reach the needed columns
+  if (a.size() > la && t >= la) {
+    const size_t len = std::min(b.size(), t - la + 1);
+    mul_high_acc(acc, a.first(a.size() - la), b.last(len), t - la,
+                 offset + (b.size() - len));
+  }
+  if (b.size() > lb && t >= lb) {
+    const size_t len = std::min(a.size(), t - lb + 1);
+    mul_high_acc(acc, a.last(len), b.first(b.size() - lb), t - lb,
+                 offset + (a.size() - len));
+  }
+}
+
+/**
+ *  @brief Performs `result = h`, with the sign of `a * b`, where `h`
+ *  approximates the leading `n` digits `floor(|a * b| / bi_base ** k)`,
+ *  `k = a.size() + b.size() - n`, and `h <= floor(|a * b| / bi_base ** k) <= h
+ *  + min(a.size(), b.size())`. Exact if `n >= a.size() + b.size()`.
+ */
+void h_::mul_high(bi_t& result, const bi_t& a, const bi_t& b, size_t n) {
+  const bool result_negative = a.negative() != b.negative();
+  const size_t size = a.size() + b.size();
+
+  if (n >= size) {
+    mul(result, a, b);
+    return;
+  }
+  if (n == 0 || a.size() == 0 || b.size() == 0) {
+    result = 0;
+    return;
+  }
+
+  bi_t acc;
+  acc.resize_(size);
+  std::fill(acc.begin(), acc.end(), 0);
+  // Keep the columns >= size - n - 1, i.e. t = n - 1 counting from the top
+  mul_high_acc(acc, a.vec_, b.vec_, n - 1, 0);
+
+  result.vec_ = dvector(acc.vec_.begin() + (size - n), acc.vec_.end());
+  result.trim();
+  result.negative_ = result_negative && result.size() != 0;
+}
+
+/**
+ *  @brief Performs `acc += a * b`, or `acc -= a * b` if `subtract` is true.
+ *  @details If the product has the sign of `acc` (or `acc` is zero) and the
+ *  operands are below the Karatsuba threshold, the partial products are added
+ *  straight into the digits of `acc`, so that no temporary is formed and the
+ *  capacity of `acc` is reused across calls. Otherwise, the product is formed
+ *  and then added.
+ */
+void h_::addmul(bi_t& acc, const bi_t& a, const bi_t& b, bool subtract) {
+  if (a.size() == 0 || b.size() == 0) {
+    return;
+  }
+
+  const bool product_negative = (a.negative() != b.negative()) != subtract;
+  const bool fused = (acc.size() == 0 || acc.negative() == product_negative) &&
+                     std::min(a.size(), b.size()) < karatsuba_threshold &&
+                     &acc != &a && &acc != &b;
+  if (!fused) {
+    bi_t product;
+    mul(product, a, b);
+    product.negative_ = product_negative;
+    add(acc, acc, product);
+    return;
+  }
+
+  const size_t m = a.size();
+  const size_t n = b.size();
+  const size_t old_size = acc.size();
+  const size_t new_size = std::max(old_size, m + n) + 1;
+  acc.resize_(new_size);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  std::fill(acc.begin() + old_size, acc.end(), 0);
+
+  for (size_t j = 0; j < n; ++j) {
+    digit k = 0;
+    for (size_t i = 0; i < m; ++i) {
+      const ddigit t = static_cast<ddigit>(a[i]) * b[j] +
+                       static_cast<ddigit>(acc[i + j]) + k;
+      k = t >> bi_dwidth;
+      acc[i + j] = static_cast<digit>(t);
+    }
+    for (size_t i = j + m; k != 0; ++i) {
+      acc[i] += k;
+      k = acc[i] < k;
+    }
+  }
+
+  acc.trim();
+  acc.negative_ = product_negative;
+}
+
+/**
+ *  @internal
+ *  @page poly_mul Polynomial Multiplication - Kronecker Substitution
+ *  @ingroup algorithms
+ *  A polynomial \f$ a(x) = \sum_{i} a_{i}x^{i} \f$ with integer coefficients
+ *  is evaluated at a power of two, \f$ A = a(2^{L}) \f$, so that
+ *  \f$ AB = (ab)(2^{L}) \f$. If every coefficient of the product satisfies
+ *  \f$ |c_{k}| < 2^{L-1} \f$, the coefficients can be read back from the
+ *  \f$ L \f$-bit slots of \f$ AB \f$. This turns the many products of the
+ *  coefficients into a single product of large integers, which benefits from
+ *  Karatsuba multiplication (Schönhage, "Asymptotically fast algorithms for
+ *  the numerical multiplication and division of polynomials with complex
+ *  coefficients", 1982).
+ *
+ *  Since \f$ |c_{k}| \leq \min(m, n) \max_{i}|a_{i}| \max_{j}|b_{j}| \f$ for
+ *  polynomials with \f$ m \f$ and \f$ n \f$ coefficients, it suffices that
+ *  \f$ L - 1 \geq \beta_{a} + \beta_{b} + \lceil \log_{2}(\min(m, n) + 1)
+ *  \rceil \f$, where the \f$ \beta \f$ are the largest bit lengths of the
+ *  coefficients. \f$ L \f$ is rounded up to whole digits, so that packing and
+ *  unpacking only copy digits.
+ *
+ *  Negative coefficients are packed separately, as
+ *  \f$ A = A^{+} - A^{-} \f$. A slot of the product holds \f$ c_{k} \f$ plus
+ *  a borrow from the slot below, so slots are unpacked from the bottom in the
+ *  balanced range \f$ [-2^{L-1}, 2^{L-1}) \f$, carrying one into the next slot
+ *  whenever a slot value is negative.
+ *  @endinternal
+ */
+/**
+ *  @private
+ *  @brief Set `x` to the polynomial with coefficients `coeffs` evaluated at
+ *  `bi_base ** slot`, where each coefficient has at most `slot` digits.
+ */
+void h_::poly_pack(bi_t& x, std::span<const bi_t> coeffs, size_t slot) {
+  bi_t pos, neg;
+  pos.resize_(coeffs.size() * slot);
+  std::fill(pos.begin(), pos.end(), 0);
+  const bool any_negative = std::any_of(
+      coeffs.begin(), coeffs.end(), [](const bi_t& c) { return c.negative(); });
+  if (any_negative) {
+    neg.resize_(coeffs.size() * slot);
+    std::fill(neg.begin(), neg.end(), 0);
+  }
+
+  for (size_t i = 0; i < coeffs.size(); ++i) {
+    const bi_t& c = coeffs[i];
+    bi_t& target = c.negative() ? neg : pos;
+    std::copy(c.begin(), c.end(), target.begin() + i * slot);
+  }
+
+  pos.trim();
+  neg.trim();
+  sub(x, pos, neg);
+}
+
+/**
+ *  @private
+ *  @brief Set `coeffs` to the `count` coefficients read back from the slots of
+ *  `slot` digits of `x`, in the balanced range.
+ */
+void h_::poly_unpack(std::vector<bi_t>& coeffs, const bi_t& x, size_t slot,
+                     size_t count) {
+  const bi_bitcount_t width = static_cast<bi_bitcount_t>(slot) * bi_dbits;
+  const bi_t half = bi_t{1} << (width - 1);
+  const bi_t full = bi_t{1} << width;
+
+  const std::span<const digit> digits(x.vec_.data(), x.size());
+  coeffs.resize(count);
+  bool carry = false;
+  for (size_t k = 0; k < count; ++k) {
+    bi_t& c = coeffs[k];
+    const size_t begin = std::min(k * slot, x.size());
+    const size_t end = std::min(begin + slot, x.size());
+    assign_digits(c, digits.subspan(begin, end - begin));
+
+    if (carry) {
+      increment_abs(c);
+    }
+    carry = c >= half;
+    if (carry) {
+      c -= full;
+    }
+    if (x.negative() && c.size() != 0) {
+      c.negative_ = !c.negative_;
+    }
+  }
+}
+
+/**
+ *  @brief Performs `result = a * b` for polynomials with coefficients `a` and
+ *  `b`, lowest degree first, by Kronecker substitution.
+ */
+void h_::poly_mul(std::vector<bi_t>& result, std::span<const bi_t> a,
+                  std::span<const bi_t> b) {
+  if (a.empty() || b.empty()) {
+    result.clear();
+    return;
+  }
+
+  const auto coeff_bits = [](std::span<const bi_t> p) {
+    bi_bitcount_t bits = 0;
+    for (const bi_t& c : p) {
+      bits = std::max(bits, c.bit_length());
+    }
+    return bits;
+  };
+  const bi_bitcount_t width = coeff_bits(a) + coeff_bits(b) +
+                              std::bit_width(std::min(a.size(), b.size())) + 1;
+  const size_t slot = uints::div_ceil(width, bi_dbits);
+
+  bi_t x, y;
+  poly_pack(x, a, slot);
+  if (a.data() == b.data() && a.size() == b.size()) {
+    mul(y, x, x);  // Squaring
+  } else {
+    poly_pack(y, b, slot);
+    mul(y, x, y);
+  }
+
+  poly_unpack(result, y, slot, a.size() + b.size() - 1);
 }
 
 /**
@@ -603,32 +1173,60 @@ void h_::mul(bi_t& w, const bi_t& u, const bi_t& v) {
  *  NOTE: Assumes space and size have already been set for q and r.
  */
 digit h_::div_algo_digit(bi_t& q, const bi_t& u, digit v) noexcept {
-  ddigit rem{0};
+  return div_algo_digit(q, u, make_reciprocal(v));
+}
 
-  for (size_t j = u.size() - 1; j < std::numeric_limits<size_t>::max(); --j) {
-    const ddigit temp = (rem << bi_dwidth) | u[j];  // rem * bi_base + u[j]
-    q[j] = temp / v;
-    rem = temp % v;
+/**
+ *  Same as above, but with a precomputed reciprocal of the divisor. Step (2)
+ *  uses `div_2by1()` on the dividend shifted left by `inv.shift` bits, so that
+ *  the remainder computed is `inv.shift` bits too large.
+ */
+digit h_::div_algo_digit(bi_t& q, const bi_t& u,
+                         const digit_reciprocal& inv) noexcept {
+  const size_t n = u.size();
+  const unsigned s = inv.shift;
+
+  digit rem = 0;
+  if (s == 0) {
+    for (size_t j = n - 1; j < std::numeric_limits<size_t>::max(); --j) {
+      std::tie(q[j], rem) = div_2by1(rem, u[j], inv);
+    }
+  } else {
+    const unsigned compl_s = bi_dwidth - s;
+    rem = u[n - 1] >> compl_s;
+    for (size_t j = n - 1; j < std::numeric_limits<size_t>::max(); --j) {
+      const digit lower = j > 0 ? u[j - 1] >> compl_s : 0;
+      std::tie(q[j], rem) = div_2by1(rem, (u[j] << s) | lower, inv);
+    }
   }
 
   q.trim();
-  return static_cast<digit>(rem);
+  return rem >> s;
 }
 
-void h_::div_algo_single(bi_t& q, bi_t& r, const bi_t& u,
-                         const bi_t& v) noexcept {
-  ddigit rem{0};
-
-  for (size_t j = u.size() - 1; j < std::numeric_limits<size_t>::max(); --j) {
-    const ddigit temp = (rem << bi_dwidth) | u[j];  // rem * bi_base + u[j]
-    q[j] = temp / v[0];
-    rem = temp % v[0];
+/**
+ *  @brief Return `|u| mod inv.d`, as `div_algo_digit()` but without forming
+ *  the quotient.
+ */
+digit h_::rem_algo_digit(const bi_t& u, const digit_reciprocal& inv) noexcept {
+  const size_t n = u.size();
+  const unsigned s = inv.shift;
+
+  digit rem = 0;
+  if (s == 0) {
+    for (size_t j = n - 1; j < std::numeric_limits<size_t>::max(); --j) {
+      rem = div_2by1(rem, u[j], inv).second;
+    }
+  } else {
+    const unsigned compl_s = bi_dwidth - s;
+    rem = n > 0 ? u[n - 1] >> compl_s : 0;
+    for (size_t j = n - 1; j < std::numeric_limits<size_t>::max(); --j) {
+      const digit lower = j > 0 ? u[j - 1] >> compl_s : 0;
+      rem = div_2by1(rem, (u[j] << s) | lower, inv).second;
+    }
   }
 
-  r[0] = static_cast<digit>(rem);
-
-  q.trim();
-  r.trim();
+  return rem >> s;
 }
 
 /**
@@ -745,53 +1343,61 @@ void h_::div_algo_binary(bi_t& q, bi_t& r, const bi_t& u, const bi_t& v) {
  *  result of \f$ (u_{n-1} \cdots u_{0})_{b} \f$ divided by \f$ d \f$.
  *  @endinternal
  */
-void h_::div_algo_knuth(bi_t& q, bi_t& r, const bi_t& u, const bi_t& v) {
-#if defined(BI_DIGIT_64_BIT)
-  using sddigit = __int128;
-#else
-  using sddigit = int64_t;
-#endif
-
-  const size_t m = u.size();
+/**
+ *  @brief Algorithm D in place. On entry, `w` holds the dividend `u` with `m`
+ *  digits; on exit, `w[0..n)` holds the remainder and `w[n..m]` holds the
+ *  quotient, where `n = v.size() >= 2` and `m >= n`. `w` must not alias `v`.
+ *  @details The normalized dividend is formed in `w` itself (growing it by one
+ *  digit, which reuses its capacity when there is room). After step (4) for
+ *  some `j`, digit `u_{j+n}` of the normalized dividend is zero and is never
+ *  read again, so it stores `q_{j}`. The normalized divisor is only formed if
+ *  `v` needs shifting, and on the stack unless it is long.
+ */
+void h_::div_algo_knuth(bi_t& w, const bi_t& v) {
+  const size_t m = w.size();
   const size_t n = v.size();
 
   /* (1) Normalize */
   // Find e such that b > 2^{e} * v_{n-1} >= b / 2
-  constexpr digit b_half = bi_base >> 1;
-  const digit v_msd = v[n - 1];
-  int e = 0;
-  while ((v_msd << e) < b_half) {
-    ++e;
-  }
+  const int e = uints::clz(v[n - 1]);
   const unsigned compl_e = bi_dwidth - e;
 
-  bi_t u_norm, v_norm;
-  u_norm.resize_(m + 1);
-  v_norm.resize_(n);
-
-  // u_norm set to u * 2^{e}. Cast to ddigit as e may be 0 which would be UB
-  u_norm[0] = u[0] << e;
-  for (size_t i = 1; i < m; ++i) {
-    u_norm[i] = (u[i] << e) | (static_cast<ddigit>(u[i - 1]) >> compl_e);
+  // w set to u * 2^{e}, from the top so that w may hold u. Cast to ddigit as e
+  // may be 0 which would be UB
+  w.resize_(m + 1);
+  w[m] = static_cast<ddigit>(w[m - 1]) >> compl_e;
+  for (size_t i = m - 1; i > 0; --i) {
+    w[i] = (w[i] << e) | (static_cast<ddigit>(w[i - 1]) >> compl_e);
   }
-  u_norm[m] = static_cast<ddigit>(u[m - 1]) >> compl_e;
+  w[0] <<= e;
 
   // v_norm set to v * 2^{e}
-  v_norm[0] = v[0] << e;
-  for (size_t i = 1; i < n; ++i) {
-    v_norm[i] = (v[i] << e) | (static_cast<ddigit>(v[i - 1]) >> compl_e);
+  std::array<digit, div_stack_digits> v_buffer;  // NOLINT
+  dvector v_heap;
+  std::span<const digit> v_norm = v.vec_;
+  if (e != 0) {
+    std::span<digit> v_shifted = v_buffer;
+    if (n > div_stack_digits) {
+      v_heap.resize(n);
+      v_shifted = v_heap;
+    }
+    v_shifted[0] = v[0] << e;
+    for (size_t i = 1; i < n; ++i) {
+      v_shifted[i] = (v[i] << e) | (static_cast<ddigit>(v[i - 1]) >> compl_e);
+    }
+    v_norm = v_shifted.first(n);
   }
 
   const digit vp = v_norm[n - 1], vpp = v_norm[n - 2];
   /* (2) Initialize j. Also (7) Loop on j */
   for (size_t j = m - n; j < std::numeric_limits<size_t>::max(); --j) {
     /* (3) Calculate q_hat */
-    const ddigit tmp = u_norm[j + n] * bi_base + u_norm[j + n - 1];
+    const ddigit tmp = w[j + n] * bi_base + w[j + n - 1];
     ddigit q_hat = tmp / vp;
     ddigit r_hat = tmp % vp;
 
     while (q_hat == bi_base ||
-           q_hat * vpp > bi_base * r_hat + u_norm[j + n - 2]) {
+           q_hat * vpp > bi_base * r_hat + w[j + n - 2]) {
       --q_hat;
       r_hat += vp;
       if (r_hat >= bi_base)
@@ -803,44 +1409,66 @@ void h_::div_algo_knuth(bi_t& q, bi_t& r, const bi_t& u, const bi_t& v) {
     for (size_t i = 0; i < n; ++i) {
       const ddigit product = q_hat * v_norm[i];
       const sddigit stmp =
-          static_cast<sddigit>(u_norm[j + i]) - static_cast<digit>(product) - b;
-      u_norm[j + i] = static_cast<digit>(stmp);
+          static_cast<sddigit>(w[j + i]) - static_cast<digit>(product) - b;
+      w[j + i] = static_cast<digit>(stmp);
       b = static_cast<sddigit>(product >> bi_dbits) - (stmp >> bi_dbits);
     }
-    const bool neg{u_norm[j + n] < b};
-    u_norm[j + n] = static_cast<digit>(u_norm[j + n] - b);
+    const bool neg{w[j + n] < b};
+    w[j + n] = static_cast<digit>(w[j + n] - b);
 
     /* (5) Test remainder */
-    q[j] = q_hat;
-
     if (neg) {
       /* (6) Add back */
       // Decrease q_{j} by 1
-      --q[j];
+      --q_hat;
 
       // Add (0v_{n-1}...v_{0})_{b} to (u_{j+n}...u_{j})_{b}
       digit c = 0;
       for (size_t i = 0; i < n; ++i) {
-        const ddigit tmp = (static_cast<ddigit>(u_norm[j + i]) + v_norm[i]) + c;
-        u_norm[j + i] = tmp;
+        const ddigit tmp = (static_cast<ddigit>(w[j + i]) + v_norm[i]) + c;
+        w[j + i] = tmp;
         c = tmp >> bi_dwidth;
       }
       // A carry will occur to the left of u_{j+n} and it should be ignored
-      u_norm[j + n] += c;
-      assert(u_norm[j + n] == 0);
+      w[j + n] += c;
     }
+    assert(w[j + n] == 0);
+    w[j + n] = q_hat;
   }
 
   /* (8) Unnormalize */
-  // (u_{n-1}...u_{0})_{b} / 2^e
-  const size_t last_idx = n - 1;
-  r[last_idx] = u_norm[last_idx] >> e;
-  for (size_t i = last_idx; i-- > 0;) {
-    r[i] = (static_cast<ddigit>(u_norm[i + 1]) << compl_e) | (u_norm[i] >> e);
+  // (u_{n-1}...u_{0})_{b} / 2^e, from the bottom so that it is in place
+  for (size_t i = 0; i < n - 1; ++i) {
+    w[i] = (static_cast<ddigit>(w[i + 1]) << compl_e) | (w[i] >> e);
   }
+  w[n - 1] >>= e;
+}
 
-  q.trim();
-  r.trim();
+/**
+ *  @private
+ *  @brief Set `x` to `value`, reserving space for `capacity` digits. Reuses
+ *  the storage of `x` if it is large enough.
+ */
+void h_::assign_reserve(bi_t& x, const bi_t& value, size_t capacity) {
+  if (&x == &value) {
+    x.reserve_(capacity);
+    return;
+  }
+  if (x.vec_.capacity() < capacity) {
+    x.resize_(0);
+    x.reserve_(capacity);
+  }
+  x.resize_(value.size());
+  std::copy(value.begin(), value.end(), x.begin());
+  x.negative_ = value.negative_;
+}
+
+/// @private Return true if `|n| < |d|` is known from the leading digits.
+bool h_::div_small(const bi_t& n, const bi_t& d) noexcept {
+  const size_t size_n = n.size();
+  const size_t size_d = d.size();
+  return size_n < size_d ||
+         (size_n == size_d && n[size_n - 1] < d[size_d - 1]);
 }
 
 /**
@@ -861,34 +1489,249 @@ void h_::divide(bi_t& Q, bi_t& R, const bi_t& N, const bi_t& D) {
     throw division_by_zero("Division by zero attempt.");
   }
 
-  const size_t size_N = N.size();
-  const size_t size_D = D.size();
+  if (&Q == &D || &R == &D) {
+    const bi_t D_copy = D;
+    divide(Q, R, N, D_copy);
+    return;
+  }
+
+  const bool N_negative = N.negative();
+  const bool Q_negative = N_negative != D.negative();
 
   // |N| < |D| case
-  if ((size_N == size_D && N[size_N - 1] < D[size_D - 1]) || size_N < size_D) {
-    Q = 0;  // |N| < |D| ==> |N| / |D| < 1 ==> Q computes to 0
+  if (div_small(N, D)) {
     R = N;  // Computation (a/b)*b + a%b should equal a ==> a%b is a
+    Q = 0;  // |N| < |D| ==> |N| / |D| < 1 ==> Q computes to 0
     return;
   }
 
-  // TRUE: size_N >= size_D > 0
+  // |D| = 2^k case: shift and mask. Each result is formed before the other
+  // overwrites N, which one of them may alias.
+  if (is_pow2_abs(D)) {
+    const bi_bitcount_t k = D.bit_length() - 1;
+    if (&R == &N) {
+      right_shift_trunc(Q, N, k);
+      low_bits(R, N, k);
+    } else {
+      low_bits(R, N, k);
+      right_shift_trunc(Q, N, k);
+    }
+    Q.negative_ = Q_negative && Q.size() != 0;
+    return;
+  }
 
-  // Ensure enough space in Q and R
+  // TRUE: size_N >= size_D > 0
+  const size_t size_N = N.size();
+  const size_t size_D = D.size();
   const size_t size_Q = size_N - size_D + 1;
-  Q.resize_(size_Q);
-  R.resize_(size_D);
+
+  // R works as the dividend; N is not read after this, so Q may alias it
+  assign_reserve(R, N, size_N + 1);
 
   // Unsigned integer division algorithms
   if (size_D == 1) {
     // Knuth (Vol. 2, 4.3.1, p. 272) recommends using the algorithm used in
-    // div_algo_single() when size_D is 1.
-    div_algo_single(Q, R, N, D);
+    // div_algo_digit() when size_D is 1.
+    Q.resize_(size_Q);
+    const digit r = div_algo_digit(Q, R, D[0]);
+    R.resize_(1);
+    R[0] = r;
+  } else {
+    div_algo_knuth(R, D);
+    Q.resize_(size_Q);
+    std::copy(R.begin() + size_D, R.begin() + size_N + 1, Q.begin());
+    Q.trim();
+    R.resize_(size_D);
+  }
+  R.trim();
+
+  Q.negative_ = Q_negative;
+  R.negative_ = R.size() > 0 && N_negative;
+}
+
+/**
+ *  @brief `x = x / d` if `remainder` is false, and `x = x % d` otherwise, with
+ *  the same results as `divide()`. Returns true if the remainder is nonzero.
+ *  @details The division is done in the storage of `x`, which grows by at most
+ *  one digit. The other result of the division is not formed.
+ *  @throw `bi::division_by_zero` if the divisor is zero.
+ */
+bool h_::div_inplace(bi_t& x, const bi_t& d, bool remainder) {
+  if (d.size() == 0) {
+    throw division_by_zero("Division by zero attempt.");
+  }
+
+  if (&x == &d) {
+    x = remainder ? 0 : 1;
+    return false;
+  }
+
+  const bool x_negative = x.negative();
+  const bool q_negative = x_negative != d.negative();
+
+  // |x| < |d| case
+  if (div_small(x, d)) {
+    const bool inexact = x.size() != 0;
+    if (!remainder) {
+      x = 0;
+    }
+    return inexact;
+  }
+
+  // |d| = 2^k case: shift or mask
+  if (is_pow2_abs(d)) {
+    const bi_bitcount_t k = d.bit_length() - 1;
+    const bool inexact = any_bit_below(x, k);
+    if (remainder) {
+      low_bits(x, x, k);
+    } else {
+      right_shift_trunc(x, x, k);
+    }
+    x.negative_ = x.size() > 0 && (remainder ? x_negative : q_negative);
+    return inexact;
+  }
+
+  const size_t size_x = x.size();
+  const size_t size_d = d.size();
+
+  bool inexact = false;
+  if (size_d == 1 && remainder) {
+    const digit r = rem_algo_digit(x, make_reciprocal(d[0]));
+    inexact = r != 0;
+    x.resize_(1);
+    x[0] = r;
+  } else if (size_d == 1) {
+    inexact = div_algo_digit(x, x, d[0]) != 0;
   } else {
-    div_algo_knuth(Q, R, N, D);
+    div_algo_knuth(x, d);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    inexact = std::any_of(x.begin(), x.begin() + size_d,
+                          [](digit v) { return v != 0; });
+    if (remainder) {
+      x.resize_(size_d);
+    } else {
+      std::copy(x.begin() + size_d, x.begin() + size_x + 1, x.begin());
+      x.resize_(size_x - size_d + 1);
+    }
+  }
+  x.trim();
+
+  x.negative_ = x.size() > 0 && (remainder ? x_negative : q_negative);
+  return inexact;
+}
+
+/**
+ *  @private
+ *  @brief Move a truncated quotient one step away from zero, i.e. `|q| += 1`,
+ *  and give it the sign of the exact quotient.
+ */
+void h_::quot_away_from_zero(bi_t& q, bool negative) {
+  increment_abs(q);
+  q.negative_ = negative;
+}
+
+/**
+ *  @private
+ *  @brief Replace a nonzero remainder `r` with `|r| < |d|` by the remainder of
+ *  the opposite sign, i.e. `|r| = |d| - |r|`, which belongs to the quotient
+ *  one step further from zero.
+ */
+void h_::rem_complement(bi_t& r, const bi_t& d, bool negative) {
+  sub_abs_gt(r, d, r);
+  r.negative_ = negative;
+}
+/**
+ *  @internal
+ *  @page divexact Division - Exact Division
+ *  @ingroup algorithms
+ *  When the divisor \f$ d \f$ is known to divide \f$ n \f$, the quotient can be
+ *  found from the *low* end of the operands (Jebelean, "An algorithm for exact
+ *  division", 1993), in the manner of Hensel's 2-adic division.
+ *
+ *  Write \f$ d = 2^{z}d' \f$ with \f$ d' \f$ odd. Since the division is exact,
+ *  \f$ n/d = (n/2^{z})/d' \f$ and \f$ n/2^{z} \f$ is an integer. An odd
+ *  \f$ d'_{0} \f$ is invertible modulo \f$ b \f$, so with \f$ u = n/2^{z} \f$,
+ *  \f$ q = u/d' \f$ and \f$ \ell \f$ the number of digits of the quotient:
+ *
+ *  1. Set \f$ i \leftarrow 0 \f$ and
+ *     \f$ \iota \leftarrow {d'_{0}}^{-1} \bmod b \f$.
+ *
+ *  2. Set \f$ q_{i} \leftarrow u_{i}\iota \bmod b \f$.
+ *
+ *  3. Set \f$ u \leftarrow (u - q_{i}d'b^{i}) \bmod b^{\ell} \f$. This clears
+ *     \f$ u_{i} \f$.
+ *
+ *  4. Increase \f$ i \f$ by one. If \f$ i < \ell \f$, go to (2).
+ *
+ *  Each quotient digit costs one multiplication instead of the estimate and
+ *  correction of Algorithm D. Since \f$ q < b^{\ell} \f$, the digits of \f$ u
+ *  \f$ at or above position \f$ \ell \f$ are never needed (Jebelean's
+ *  observation), so neither is the top part of each \f$ q_{i}d' \f$, and only
+ *  \f$ u \bmod b^{\ell} \f$ is read. This makes the cost
+ *  \f$ O(\ell \min(\ell, m)) \f$ for an \f$ m \f$-digit divisor.
+ *
+ *  The result is unspecified if \f$ d \f$ does not divide \f$ n \f$.
+ *  @endinternal
+ */
+/**
+ *  @brief `Q = N / D`, where `D` is known to divide `N`.
+ *  @throw `bi::division_by_zero` if the divisor is zero.
+ */
+void h_::divexact(bi_t& Q, const bi_t& N, const bi_t& D) {
+  if (D.size() == 0) {
+    throw division_by_zero("Division by zero attempt.");
+  }
+
+  const bool negative = N.negative() != D.negative();
+  if (N.size() < D.size()) {
+    Q = 0;
+    return;
+  }
+
+  // Remove the factor 2^z from both operands
+  const bi_bitcount_t z = trailing_zeros(D);
+
+  bi_t v;
+  right_shift(v, D, z);
+  v.negative_ = false;
+
+  // Only u mod b^l is needed, where l is the number of quotient digits
+  bi_t u;
+  right_shift(u, N, z);
+  u.negative_ = false;
+  if (u.size() < v.size()) {
+    Q = 0;
+    return;
   }
+  const size_t m = v.size();
+  const size_t l = u.size() - m + 1;
+  u.resize_(l);
 
-  Q.negative_ = D.negative() ^ N.negative();
-  R.negative_ = R.size() > 0 && N.negative();
+  const digit inv = uints::inverse_mod_pow2(v[0]);
+  for (size_t i = 0; i < l; ++i) {
+    const digit q = u[i] * inv;
+
+    // u <- (u - q * v * b^i) mod b^l; the first step clears u[i]
+    const size_t len = std::min(m, l - i);
+    digit k = 0;
+    for (size_t j = 0; j < len; ++j) {
+      const ddigit p = static_cast<ddigit>(q) * v[j] + k;
+      const digit lo = static_cast<digit>(p);
+      k = static_cast<digit>(p >> bi_dwidth) + (u[i + j] < lo);
+      u[i + j] -= lo;
+    }
+    for (size_t j = i + len; k != 0 && j < l; ++j) {
+      const digit t = u[j];
+      u[j] = t - k;
+      k = t < k;
+    }
+
+    u[i] = q;  // Quotient digits replace the cleared digits of u
+  }
+
+  u.trim();
+  u.negative_ = negative && u.size() != 0;
+  Q.swap(u);
 }
 
 /**
@@ -967,26 +1810,37 @@ void h_::left_shift(bi_t& result, const bi_t& x, bi_bitcount_t n_bits) {
  *  @note No temporary is needed for in-place right-shifting.
  */
 void h_::right_shift(bi_t& result, const bi_t& x, bi_bitcount_t n_bits) {
-  // TODO: maybe set `result = x` for special cases x.size() == 0 || n_bits == 0
+  // For negative x, floor division subtracts one from trunc(x / 2^{n_bits}) if
+  // any of the shifted-out bits are set. Determine this before writing to
+  // result, which may alias x.
+  const bool subtract_one = x.negative() && any_bit_below(x, n_bits);
+
+  right_shift_trunc(result, x, n_bits);
+
+  // Adjust for floor division for negative numbers
+  if (subtract_one) {
+    --result;
+  }
+}
+
+/**
+ *  @brief `result = trunc(x / 2^{n_bits})`, i.e. `|x|` shifted right with the
+ *  sign of `x`.
+ *  @details Never allocates when `&result == &x`.
+ */
+void h_::right_shift_trunc(bi_t& result, const bi_t& x, bi_bitcount_t n_bits) {
   const size_t size_x = x.size();
 
   const bi_bitcount_t digit_shift = n_bits / bi_dwidth;
   const unsigned bit_shift = n_bits % bi_dwidth;
 
   if (size_x <= digit_shift) {
-    if (x.negative()) {
-      // Set result to -1
-      result.resize_(1);
-      result[0] = 1;
-      result.negative_ = true;
-    } else {
-      // Set result to 0
-      result.resize_unsafe_(0);
-      result.negative_ = false;
-    }
+    result.resize_unsafe_(0);
+    result.negative_ = false;
     return;
   }
 
+  const bool x_negative = x.negative();
   result.resize_(size_x - digit_shift);
 
   if (bit_shift == 0) {
@@ -1005,31 +1859,49 @@ void h_::right_shift(bi_t& result, const bi_t& x, bi_bitcount_t n_bits) {
   }
 
   result.trim();
-  result.negative_ = x.negative();
+  result.negative_ = x_negative && result.size() != 0;
+}
 
-  // At this point, the result is trunc(x / 2^{n_bits}) for all x
+/**
+ *  @brief `result = x % 2^{n_bits}`, i.e. the low `n_bits` bits of `|x|` with
+ *  the sign of `x`.
+ *  @details Only the low digits of `x` are read. Never allocates when
+ *  `&result == &x`.
+ */
+void h_::low_bits(bi_t& result, const bi_t& x, bi_bitcount_t n_bits) {
+  const bi_bitcount_t digit_count = n_bits / bi_dwidth;
+  const unsigned bit_count = n_bits % bi_dwidth;
+  const size_t size = digit_count < x.size()
+                          ? digit_count + (bit_count != 0 ? 1 : 0)
+                          : x.size();
+
+  if (&result != &x) {
+    result.resize_(size);
+    std::copy_n(x.begin(), size, result.begin());
+    result.negative_ = x.negative_;
+  } else {
+    result.resize_unsafe_(size);
+  }
 
-  // Adjust for floor division for negative numbers
-  if (x.negative()) {
-    bool subtract_one = false;
-    if (bit_shift > 0) {
-      const digit mask = (static_cast<digit>(1) << bit_shift) - 1;
-      if ((x[digit_shift] & mask) != 0) {
-        subtract_one = true;
-      }
-    }
-    if (!subtract_one && digit_shift > 0) {
-      for (size_t i = 0; i < digit_shift; ++i) {
-        if (x[i] != 0) {
-          subtract_one = true;
-          break;
-        }
-      }
-    }
-    if (subtract_one) {
-      --result;
-    }
+  if (bit_count != 0 && digit_count < size) {
+    result[digit_count] &= (digit{1} << bit_count) - 1;
+  }
+  result.trim();
+}
+
+/**
+ *  @brief Return whether `|x|` is a power of two.
+ *  @details The leading digit must have a single bit set, which usually
+ *  settles it; only then are the other digits read.
+ */
+bool h_::is_pow2_abs(const bi_t& x) noexcept {
+  const size_t size = x.size();
+  if (size == 0 || !std::has_single_bit(x[size - 1])) {
+    return false;
   }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  return std::all_of(x.begin(), x.begin() + (size - 1),
+                     [](digit v) { return v == 0; });
 }
 
 ///@}
@@ -1166,11 +2038,8 @@ int h_::cmp(const bi_t& a, T b) noexcept {
   if constexpr (std::numeric_limits<UnsignedT>::max() <= bi_dmax) {
     n_b_digits = (unsigned_b != 0) ? 1 : 0;
   } else {
-    UnsignedT temp_b = unsigned_b;
-    while (temp_b != 0) {
-      temp_b >>= bi_dwidth;
-      n_b_digits++;
-    }
+    n_b_digits = uints::div_ceil(unsigned{uints::bit_length(unsigned_b)},
+                                 bi_dwidth);
   }
 
   const size_t a_size = a.size();
@@ -1599,6 +2468,8 @@ struct BaseMBS {
   unsigned mbs;
   // base ** mbs
   digit base_pow_mbs;
+  // reciprocal of base ** mbs, for repeated division by it
+  digit_reciprocal base_pow_mbs_inv;
 };
 
 // For example, if digit <==> uint32_t (uint64_t), 10^{9} (10^{19}) is the
@@ -1608,7 +2479,9 @@ constexpr std::array<BaseMBS, 37> create_base_mbs_array() {
   std::array<BaseMBS, 37> base_mbs{};
   for (int base = 2; base <= 36; ++base) {
     unsigned max_batch_size = calculate_max_batch_size(base);
-    base_mbs.at(base) = {max_batch_size, pow(base, max_batch_size)};
+    const digit base_pow_mbs = pow(base, max_batch_size);
+    base_mbs.at(base) = {max_batch_size, base_pow_mbs,
+                         make_reciprocal(base_pow_mbs)};
   }
   return base_mbs;
 }
@@ -1616,15 +2489,16 @@ constexpr std::array<BaseMBS, 37> create_base_mbs_array() {
 
 constexpr auto base_mbs = create_base_mbs_array();
 
+// Radix conversions of integers of more than this many digits divide and
+// conquer
+constexpr size_t conversion_dc_threshold = 2 * karatsuba_threshold;
+
 void h_::init_string(bi_t& x, const std::string& s, int base) {
   // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
   if (base <= 1 || base > 36) {
     throw std::invalid_argument("base argument must be in [2, 36]");
   }
 
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
-  const auto [max_batch_size, base_pow_max_batch_size] = base_mbs[base];
-
   // std::stoi and company allow leading whitespace and a plus/minus sign. We
   // follow suit.
 
@@ -1633,10 +2507,10 @@ void h_::init_string(bi_t& x, const std::string& s, int base) {
                              [](char ch) { return std::isspace(ch); });
 
   // Allow plus/minus sign to precede first base-`base` digit
-  x.negative_ = false;
+  bool negative = false;
   if (it != s.end()) {
     if (*it == '-') {
-      x.negative_ = true;
+      negative = true;
       ++it;
     } else if (*it == '+') {
       ++it;
@@ -1652,13 +2526,50 @@ void h_::init_string(bi_t& x, const std::string& s, int base) {
     throw std::invalid_argument("Invalid string format.");
   }
 
-  size_t n_base = std::distance(start_digit, it);  // it - start_digit
+  x.negative_ = false;
+  h_::parse_digits(x, start_digit, it, base);
+  x.negative_ = negative && x.size() != 0;
+}
+
+/**
+ *  Set `x` to the value of the base-`base` digits in `[first, last)`.
+ *
+ *  Short strings are converted batch by batch, each batch being a digit's
+ *  worth of characters, with one multiply-add pass over `x` per batch, which
+ *  is quadratic. Longer strings are split so that the low part has
+ *  \f$ 2^{k} \f$ characters, and `x` is then
+ *  \f$ \text{high} \cdot base^{2^{k}} + \text{low} \f$. The power comes from
+ *  the process-wide `power_cache`, so that it is computed once for all
+ *  conversions, and the cost of the conversion is that of the
+ *  multiplications.
+ */
+void h_::parse_digits(bi_t& x, std::string::const_iterator first,
+                      std::string::const_iterator last, int base) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+  const BaseMBS& base_batch = base_mbs[base];
+  const unsigned max_batch_size = base_batch.mbs;
+  const digit base_pow_max_batch_size = base_batch.base_pow_mbs;
+
+  const auto n_base = static_cast<size_t>(std::distance(first, last));
+  if (n_base > conversion_dc_threshold * max_batch_size) {
+    const auto k = static_cast<unsigned>(std::bit_width(n_base - 1) - 1);
+    const size_t low_length = size_t{1} << k;
+    bi_t low;
+    h_::parse_digits(low, last - static_cast<ptrdiff_t>(low_length), last,
+                     base);
+    h_::parse_digits(x, first, last - static_cast<ptrdiff_t>(low_length),
+                     base);
+    x *= *power_cache::get(base, k);
+    x += low;
+    return;
+  }
+
   const size_t n_digits = uints::div_ceil(n_base, max_batch_size);
 
   x.reserve_(n_digits);
   x.resize_unsafe_(0);
 
-  auto dec_it = start_digit;
+  auto dec_it = first;
   const size_t rem_batch_size = n_base % max_batch_size;
 
   // Initialize batch value
@@ -1673,7 +2584,7 @@ void h_::init_string(bi_t& x, const std::string& s, int base) {
     x.vec_.push_back(batch);
   }
 
-  while (dec_it < it) {
+  while (dec_it < last) {
     // Initialize batch value
     batch = 0;
     // Convert batch substring to integer value
@@ -1687,6 +2598,84 @@ void h_::init_string(bi_t& x, const std::string& s, int base) {
   x.trim();
 }
 
+/**
+ *  Append the base-`base` digits of `x >= 0` to `out`, padded with leading
+ *  zeros to `width` characters. `x` is consumed.
+ *
+ *  Small integers are converted batch by batch, dividing `x` by the largest
+ *  power of `base` that fits in a digit, which is quadratic. Larger ones are
+ *  divided by a cached power \f$ base^{2^{k}} \f$ with about half as many
+ *  digits, and the quotient and the remainder (padded to \f$ 2^{k} \f$
+ *  characters) are converted in turn.
+ */
+void h_::format_digits(std::string& out, bi_t& x, int base, size_t width) {
+  // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+  static constexpr auto base_digits = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+  const BaseMBS& base_batch = base_mbs[base];
+  const unsigned max_batch_size = base_batch.mbs;
+
+  if (x.size() > conversion_dc_threshold) {
+    // Each digit holds at least max_batch_size characters
+    const auto k = static_cast<unsigned>(
+        std::bit_width(x.size() * max_batch_size / 2) - 1);
+    const size_t low_length = size_t{1} << k;
+    bi_t q;
+    bi_t r;
+    h_::divide(q, r, x, *power_cache::get(base, k));
+    if (q.size() == 0) {
+      h_::format_digits(out, r, base, width);
+      return;
+    }
+    const size_t high_width = width > low_length ? width - low_length : 0;
+    if (x.size() >= parallel_digits_threshold && parallel::max_threads() > 1 &&
+        !parallel::in_parallel_region()) {
+      // Both halves at once. The low half goes to a string of its own, which
+      // the thread converting it allocates, on its NUMA node.
+      std::string low;
+      parallel::for_each_index(
+          2,
+          [&](size_t i) {
+            if (i == 0) {
+              h_::format_digits(out, q, base, high_width);
+            } else {
+              h_::format_digits(low, r, base, low_length);
+            }
+          },
+          2);
+      out += low;
+      return;
+    }
+    h_::format_digits(out, q, base, high_width);
+    h_::format_digits(out, r, base, low_length);
+    return;
+  }
+
+  const size_t start = out.size();
+  while (x.size()) {
+    digit remainder = h_::div_algo_digit(x, x, base_batch.base_pow_mbs_inv);
+
+    for (unsigned i = 0; i < max_batch_size; ++i) {
+      if (remainder == 0 && x.size() == 0) {
+        break;
+      }
+
+      digit current_digit = remainder % base;
+      remainder /= base;
+
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      out.push_back(base_digits[current_digit]);
+    }
+  }
+  if (out.size() - start < width) {
+    out.append(width - (out.size() - start), '0');
+  }
+
+  std::reverse(out.begin() + static_cast<ptrdiff_t>(start), out.end());
+  // NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+}
+
 ///@}
 
 /// @private
@@ -1718,78 +2707,215 @@ inline void h_::to_twos_complement_in_place(dvector& vec) noexcept {
 }
 
 /**
- *  From C++20 (7.3.10, p. 93): "A prvalue of a floating-point type can be
- *  converted to a prvalue of an integer type. The conversion truncates; that
- *  is, the fractional part is discarded. The behavior is undefined if the
+ *  @brief Set `x` to `value` truncated toward zero.
+ *  @details From C++20 (7.3.10, p. 93): "A prvalue of a floating-point type
+ *  can be converted to a prvalue of an integer type. The conversion truncates;
+ *  that is, the fractional part is discarded. The behavior is undefined if the
  *  truncated value cannot be represented in the destination type."
+ *
+ *  `std::frexp()` splits `value` into \f$ m \cdot 2^{e} \f$ with
+ *  \f$ 0.5 \leq m < 1 \f$. The integer part of `value` is then the integer
+ *  \f$ \lfloor m 2^{\min(e, p)} \rfloor \f$, which has at most \f$ p \f$
+ *  bits for a precision of \f$ p \f$ bits, shifted left by
+ *  \f$ \max(e - p, 0) \f$ bits. The digits of the former are read off
+ *  exactly with `std::fmod()`, so that the cost does not depend on \f$ e \f$
+ *  beyond the final shift.
  */
-void h_::assign_from_double(bi_t& x, double d) {
-  if (std::isnan(d) || std::isinf(d)) {
+template <std::floating_point F>
+void h_::assign_from_floating(bi_t& x, F value) {
+  if (std::isnan(value) || std::isinf(value)) {
     throw from_float(
         "Conversion error: NaN or infinity cannot be converted to an integer.");
   }
 
-  if (d > -1 && d < 1) {
+  int exp{};
+  const F m = std::frexp(std::fabs(value), &exp);
+  if (exp <= 0) {
     x = 0;
     return;
   }
 
-  const bool neg = d < 0;
-  if (neg) {
-    d = -d;
-  }
+  constexpr int p = std::numeric_limits<F>::digits;
+  constexpr size_t max_digits = uints::div_ceil(unsigned{p}, bi_dbits);
+  const F base = std::ldexp(F{1}, bi_dbits);
+  const F base_reciprocal = std::ldexp(F{1}, -static_cast<int>(bi_dbits));
 
-  size_t n_digits{1};
-  while (bi_base_dbl <= d) {
-    // Equiv. to `d /= bi_base_dbl;`, but multiplication is generally cheaper
-    d *= bi_base_dbl_reciprocal;
-    ++n_digits;
+  F integer = std::trunc(std::ldexp(m, std::min(exp, p)));
+  x.resize_(max_digits);
+  for (size_t i = 0; i < max_digits; ++i) {
+    const F d = std::fmod(integer, base);
+    x[i] = static_cast<digit>(d);
+    integer = (integer - d) * base_reciprocal;
   }
+  x.negative_ = false;
+  x.trim();
 
-  x.resize_(n_digits);
+  if (exp > p) {
+    x <<= static_cast<bi_bitcount_t>(exp - p);
+  }
+  x.negative_ = value < 0 && x.size() != 0;
+}
 
-  for (size_t i = n_digits; i-- > 0;) {
-    x[i] = static_cast<digit>(d);
-    d = (d - static_cast<double>(x[i])) * bi_base_dbl;
+/**
+ *  @private
+ *  @brief Return the `count <= bi_dbits` bits of `|x|` starting at bit `pos`.
+ */
+digit h_::bits_at(const bi_t& x, bi_bitcount_t pos,
+                  unsigned count) noexcept {
+  const size_t index = pos / bi_dbits;
+  const unsigned offset = pos % bi_dbits;
+  if (index >= x.size()) {
+    return 0;
   }
 
-  x.negative_ = neg;
-  x.trim();
+  digit bits = x[index] >> offset;
+  if (offset != 0 && index + 1 < x.size()) {
+    bits |= x[index + 1] << (bi_dbits - offset);
+  }
+  return count < bi_dbits ? bits & ((digit{1} << count) - 1) : bits;
 }
 
-int h_::cmp_abs(const bi_t& z, double dbl) noexcept {
-  if (z.size() == 0) {
-    return dbl > 0 ? -1 : 0;
+/// @private
+/// @brief Return whether any of the bits of `|x|` below bit `pos` is set.
+bool h_::any_bit_below(const bi_t& x, bi_bitcount_t pos) noexcept {
+  size_t index = pos / bi_dbits;
+  const unsigned offset = pos % bi_dbits;
+  if (index >= x.size()) {
+    return x.size() != 0;
+  }
+  if (offset != 0 && (x[index] & ((digit{1} << offset) - 1)) != 0) {
+    return true;
+  }
+  // From the top, so that the scan usually stops at the first digit
+  while (index-- > 0) {
+    if (x[index] != 0) {
+      return true;
+    }
   }
+  return false;
+}
 
-  if (z.size() >= bi_cmp_dbl_size_upper) {
-    return 1;
+/**
+ *  @brief Return `x` rounded to the floating-point type `F` according to
+ *  `mode`.
+ *  @details Only the leading \f$ p \f$ bits of `x`, for a precision of
+ *  \f$ p \f$ bits, are read, plus the bit below them (the round bit) and,
+ *  when it decides the result, whether any lower bit is set (the sticky
+ *  bit). The sticky bit is found by scanning down from the round bit, which
+ *  usually stops at once. The leading bits form an integer below
+ *  \f$ 2^{p} \f$, which is exact in `F`, so the only rounding is the one
+ *  chosen by `mode`.
+ *
+ *  A result beyond the range of `F` is infinite when rounding to nearest and
+ *  when rounding away from zero, and the largest finite value otherwise.
+ */
+template <std::floating_point F>
+F h_::to_floating(const bi_t& x, rounding mode) noexcept {
+  if (x.size() == 0) {
+    return F{0};
+  }
+
+  constexpr int p = std::numeric_limits<F>::digits;
+  const bi_bitcount_t n = x.bit_length();
+  const bi_bitcount_t shift = n > p ? n - p : 0;
+  const auto width = static_cast<unsigned>(n - shift);
+
+  // The leading `width <= p` bits, most significant chunk first
+  F mantissa{0};
+  unsigned done = 0;
+  while (done < width) {
+    const unsigned chunk = std::min(width - done, unsigned{bi_dbits});
+    done += chunk;
+    const digit bits = bits_at(x, shift + (width - done), chunk);
+    mantissa = std::ldexp(mantissa, static_cast<int>(chunk)) +
+               static_cast<F>(bits);
+  }
+
+  bi_bitcount_t bit_length = n;
+  if (shift != 0) {
+    const bool round_bit = bits_at(x, shift - 1, 1) != 0;
+    const bool sticky = any_bit_below(x, shift - 1);
+    const int half = round_bit ? (sticky ? 1 : 0) : -1;
+    const bool odd = std::fmod(mantissa, F{2}) != 0;
+    if (round_away(mode, x.negative(), odd, half, round_bit || sticky)) {
+      mantissa += 1;
+      if (mantissa == std::ldexp(F{1}, p)) {
+        ++bit_length;
+      }
+    }
   }
 
-  // Same as dbl = std::ldexp(dbl, -static_cast<int>(bi_dbits) *
-  //                                static_cast<int>(z.size() - 1));
-  for (size_t j = 1; j < z.size(); ++j) {
-    // Equiv. to `dbl /= bi_base_dbl;`, but multiplication is generally cheaper
-    dbl *= bi_base_dbl_reciprocal;
+  F result{};
+  if (bit_length > static_cast<bi_bitcount_t>(
+                       std::numeric_limits<F>::max_exponent)) {
+    const bool to_infinity =
+        mode == rounding::half_even || mode == rounding::half_away_from_zero ||
+        mode == rounding::half_toward_zero ||
+        round_away(mode, x.negative(), false, -1, true);
+    result = to_infinity ? std::numeric_limits<F>::infinity()
+                         : std::numeric_limits<F>::max();
+  } else {
+    result = std::ldexp(mantissa, static_cast<int>(shift));
   }
 
-  if (bi_base_dbl <= dbl) {
+  return x.negative() ? -result : result;
+}
+
+/**
+ *  @brief Compare `|z|` with `dbl >= 0`. Return -1, 0, or 1 if `|z|` is less
+ *  than, equal to, or greater than `dbl`.
+ *  @details Almost all comparisons are decided by comparing the bit length of
+ *  `z` with the binary exponent of `dbl` from `std::frexp()`. Otherwise, the
+ *  53-bit mantissa of `dbl` is compared with the leading 53 bits of `z`, and
+ *  only if they are equal are the remaining bits of `z` scanned (from the
+ *  top, stopping at the first nonzero digit).
+ */
+int h_::cmp_abs(const bi_t& z, double dbl) noexcept {
+  if (std::isinf(dbl)) {
     return -1;
   }
+  if (z.size() == 0) {
+    return dbl > 0 ? -1 : 0;
+  }
+  if (dbl < 1) {
+    return 1;
+  }
 
-  for (auto it = z.rbegin(); it != z.rend(); ++it) {
-    const digit cur = static_cast<digit>(dbl);
+  // 2^(exp - 1) <= dbl < 2^exp and 2^(n - 1) <= |z| < 2^n
+  int exp{};
+  const double m = std::frexp(dbl, &exp);
+  const bi_bitcount_t n = z.bit_length();
+  if (n != static_cast<bi_bitcount_t>(exp)) {
+    return n < static_cast<bi_bitcount_t>(exp) ? -1 : 1;
+  }
 
-    if (*it < cur) {
-      return -1;
-    } else if (*it > cur) {
-      return 1;
-    } else {
-      dbl = (dbl - static_cast<double>(cur)) * bi_base_dbl;
+  constexpr int p = std::numeric_limits<double>::digits;
+  if (exp <= p) {
+    // |z| < 2^53 is exact as a double
+    uint64_t value = z[0];
+    if constexpr (bi_dbits < p) {
+      if (z.size() > 1) {
+        value |= static_cast<uint64_t>(z[1]) << bi_dbits;
+      }
     }
+    const auto z_dbl = static_cast<double>(value);
+    return z_dbl < dbl ? -1 : (z_dbl > dbl ? 1 : 0);
   }
 
-  return dbl > 0 ? -1 : 0;
+  // dbl = mantissa * 2^shift is an integer; compare with the top 53 bits of z
+  const auto shift = static_cast<bi_bitcount_t>(exp - p);
+  const auto mantissa = static_cast<uint64_t>(std::ldexp(m, p));
+  uint64_t top = 0;
+  unsigned done = 0;
+  while (done < p) {
+    const unsigned chunk = std::min(unsigned{p} - done, unsigned{bi_dbits});
+    top |= static_cast<uint64_t>(bits_at(z, shift + done, chunk)) << done;
+    done += chunk;
+  }
+  if (top != mantissa) {
+    return top < mantissa ? -1 : 1;
+  }
+  return any_bit_below(z, shift) ? 1 : 0;
 }
 
 int h_::cmp(const bi_t& z, double dbl) noexcept {
@@ -1827,6 +2953,464 @@ bi_t h_::expo_left_to_right(const bi_t& base, T exp) {
 
 ///@}
 
+/**
+ *  @internal
+ *  @page gcd Greatest Common Divisor - Lehmer
+ *  @ingroup algorithms
+ *  Knuth Algorithm L (Vol. 2, 4.5.2, pp. 345-346)
+ *  ***
+ *  **Input**: \f$ u \geq v \geq 0 \f$, multiple-precision.
+ *
+ *  **Output**: \f$ \gcd(u, v) \f$.
+ *
+ *  Euclid's algorithm spends almost all of its time on multiple-precision
+ *  divisions whose quotients are tiny. Lehmer's observation is that the first
+ *  several quotients of the Euclidean sequence depend only on the leading
+ *  digits of \f$ u \f$ and \f$ v \f$.
+ *
+ *  1. If \f$ v \f$ fits in a single digit, finish with a single-precision
+ *  Euclid. Otherwise, let \f$ \hat{u} \f$ and \f$ \hat{v} \f$ be the leading
+ *  bits of \f$ u \f$ and of \f$ v \f$ at the same bit position. Set
+ *  \f$ A \leftarrow 1, B \leftarrow 0, C \leftarrow 0, D \leftarrow 1 \f$.
+ *
+ *  2. If \f$ \hat{v} + C = 0 \f$ or \f$ \hat{v} + D = 0 \f$, go to (4).
+ *  Otherwise, set \f$ q \leftarrow \lfloor (\hat{u} + A) / (\hat{v} + C)
+ *  \rfloor \f$. If \f$ q \neq \lfloor (\hat{u} + B) / (\hat{v} + D) \rfloor
+ *  \f$, go to (4).
+ *
+ *  3. Set
+ *  \f{align}{
+ *    (A, B, C, D) &\leftarrow (C, D, A - qC, B - qD)                         \\
+ *    (\hat{u}, \hat{v}) &\leftarrow (\hat{v}, \hat{u} - q\hat{v})
+ *  \f}
+ *  and go back to (2).
+ *
+ *  4. If \f$ B = 0 \f$, perform one multiple-precision Euclid step,
+ *  \f$ (u, v) \leftarrow (v, u \bmod v) \f$. Otherwise, set
+ *  \f$ (u, v) \leftarrow (Au + Bv, Cu + Dv) \f$ in a single pass over the
+ *  digits. Go to (1).
+ *
+ *  The cofactors stay below the digit base, so step (4) costs one linear pass
+ *  in place of several multiple-precision divisions.
+ *  @endinternal
+ */
+/**
+ *  @name Greatest common divisor
+ */
+///@{
+
+/// Return `floor(|x| / 2^{shift})`, assuming it fits in a digit.
+digit h_::top_bits(const bi_t& x, bi_bitcount_t shift) noexcept {
+  const size_t i = shift / bi_dbits;
+  const unsigned r = shift % bi_dbits;
+
+  if (i >= x.size()) {
+    return 0;
+  }
+
+  ddigit window = x[i];
+  if (i + 1 < x.size()) {
+    window |= static_cast<ddigit>(x[i + 1]) << bi_dbits;
+  }
+
+  return static_cast<digit>(window >> r);
+}
+
+/**
+ *  Set `(u, v)` to `(a * u + b * v, c * u + d * v)` in place, where the
+ *  cofactors come from Lehmer's single-precision simulation: `a` and `b` (and
+ *  `c` and `d`) have opposite signs, their magnitudes are below
+ *  `2^{bi_dbits - 1}`, and both results are known to be nonnegative and no
+ *  larger than `u`.
+ */
+void h_::lehmer_update(bi_t& u, bi_t& v, sddigit a, sddigit b, sddigit c,
+                       sddigit d) {
+  const size_t n = u.size();
+  const size_t n_v = v.size();
+  v.resize_(n);
+
+  sddigit carry_u = 0;
+  sddigit carry_v = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const sddigit ui = u[i];
+    const sddigit vi = i < n_v ? v[i] : 0;
+
+    carry_u += a * ui + b * vi;
+    carry_v += c * ui + d * vi;
+
+    u[i] = static_cast<digit>(carry_u);
+    v[i] = static_cast<digit>(carry_v);
+    // Arithmetic shifts, i.e. floor(carry / bi_base)
+    carry_u >>= bi_dbits;
+    carry_v >>= bi_dbits;
+  }
+  assert(carry_u == 0 && carry_v == 0);
+
+  u.trim();
+  v.trim();
+}
+
+void h_::gcd(bi_t& result, const bi_t& a, const bi_t& b) {
+  bi_t u{a};
+  bi_t v{b};
+  u.negative_ = false;
+  v.negative_ = false;
+
+  if (cmp_abs(u, v) < 0) {
+    u.swap(v);
+  }
+
+  bi_t quot, rem;
+  while (v.size() > 1) {
+    /* (1) */
+    // Leading bi_dbits - 1 bits of u, so that all cofactors fit in a digit
+    const bi_bitcount_t shift = u.bit_length() - (bi_dbits - 1);
+    sddigit u_hat = top_bits(u, shift);
+    sddigit v_hat = top_bits(v, shift);
+    sddigit A = 1, B = 0, C = 0, D = 1;
+
+    /* (2), (3) */
+    while (v_hat + C != 0 && v_hat + D != 0) {
+      const sddigit q = (u_hat + A) / (v_hat + C);
+      if (q != (u_hat + B) / (v_hat + D)) {
+        break;
+      }
+
+      sddigit t = A - q * C;
+      A = C;
+      C = t;
+      t = B - q * D;
+      B = D;
+      D = t;
+      t = u_hat - q * v_hat;
+      u_hat = v_hat;
+      v_hat = t;
+    }
+
+    /* (4) */
+    if (B == 0) {
+      divide(quot, rem, u, v);
+      u.swap(v);
+      v.swap(rem);
+    } else {
+      lehmer_update(u, v, A, B, C, D);
+    }
+  }
+
+  if (v.size() == 0) {
+    result.swap(u);
+    return;
+  }
+
+  // Single-precision Euclid: first reduce u modulo the single digit of v
+  ddigit rem_u = 0;
+  for (size_t j = u.size(); j-- > 0;) {
+    rem_u = ((rem_u << bi_dwidth) | u[j]) % v[0];
+  }
+
+  digit x = v[0];
+  auto y = static_cast<digit>(rem_u);
+  while (y != 0) {
+    const digit t = x % y;
+    x = y;
+    y = t;
+  }
+
+  result = x;
+}
+
+///@}
+
+/**
+ *  @name Number theory
+ */
+///@{
+
+/// Return the number of trailing zero bits of the nonzero `x`.
+bi_bitcount_t h_::trailing_zeros(const bi_t& x) noexcept {
+  size_t i = 0;
+  while (x[i] == 0) {
+    ++i;
+  }
+  return static_cast<bi_bitcount_t>(i) * bi_dbits + std::countr_zero(x[i]);
+}
+
+/// Performs `result = a * b mod |m|`, for `0 <= a, b < |m|`.
+void h_::mulmod(bi_t& result, const bi_t& a, const bi_t& b, const bi_t& m) {
+  mul(result, a, b);
+  div_inplace(result, m, true);
+}
+
+/**
+ *  @brief Performs `result = base ** exp mod |m|`, with `0 <= result < |m|`.
+ *  @details Left-to-right binary exponentiation. Each step reduces its
+ *  product in place, so the working storage is allocated once.
+ *  @throw `bi::division_by_zero` if `m` is zero.
+ *  @throw `std::invalid_argument` if `exp` is negative.
+ */
+void h_::powmod(bi_t& result, const bi_t& base, const bi_t& exp,
+                const bi_t& m) {
+  if (m.size() == 0) {
+    throw division_by_zero("Division by zero attempt.");
+  }
+  if (exp.negative()) {
+    throw std::invalid_argument("Negative exponent.");
+  }
+
+  bi_t b = base;
+  div_inplace(b, m, true);
+  if (b.negative()) {
+    rem_complement(b, m, false);
+  }
+
+  bi_t r = m.size() == 1 && m[0] == 1 ? 0 : 1;
+  bi_t t;
+  for (bi_bitcount_t j = exp.bit_length(); j-- > 0;) {
+    mulmod(t, r, r, m);
+    if (exp.test_bit(j)) {
+      mulmod(r, t, b, m);
+    } else {
+      r.swap(t);
+    }
+  }
+
+  result.swap(r);
+}
+
+/**
+ *  @internal
+ *  @page jacobi Jacobi Symbol
+ *  @ingroup algorithms
+ *  For odd \f$ n > 0 \f$, the Jacobi symbol \f$ (a/n) \f$ is determined by
+ *  (Cohen, "A Course in Computational Algebraic Number Theory", Algorithm
+ *  1.4.10):
+ *  - \f$ (a/n) = ((a \bmod n)/n) \f$,
+ *  - \f$ (2/n) = (-1)^{(n^{2} - 1)/8} \f$, i.e. \f$ -1 \f$ iff
+ *    \f$ n \equiv \pm 3 \pmod{8} \f$,
+ *  - for odd \f$ a \f$, \f$ (a/n) = (n/a) \f$ unless
+ *    \f$ a \equiv n \equiv 3 \pmod{4} \f$, when \f$ (a/n) = -(n/a) \f$
+ *    (reciprocity),
+ *  - \f$ (0/n) = 0 \f$ for \f$ n > 1 \f$ and \f$ (a/1) = 1 \f$.
+ *
+ *  Removing the factors of two from \f$ a \f$ only needs the count of
+ *  trailing zeros and the low bits of \f$ n \f$, and each reciprocity step
+ *  only needs the low two bits of both, so the sign is tracked from the least
+ *  significant digits alone. While \f$ n \f$ has several digits, each step
+ *  reduces the larger operand modulo the smaller, as in Euclid's algorithm.
+ *  Once \f$ n \f$ fits in a digit, the rest is done in single-precision words
+ *  with the binary algorithm, which replaces the reductions by subtractions
+ *  of odd numbers followed by shifts.
+ *  @endinternal
+ */
+/**
+ *  @private
+ *  @brief Return `s * (a / n)` for odd `n` and `a < n`, with the binary
+ *  algorithm.
+ */
+int h_::jacobi_digit(digit a, digit n, int s) noexcept {
+  while (a != 0) {
+    const int z = std::countr_zero(a);
+    a >>= z;
+    if (z % 2 != 0 && ((n & 7) == 3 || (n & 7) == 5)) {
+      s = -s;
+    }
+    if (a < n) {
+      std::swap(a, n);
+      if ((a & n & 3) == 3) {
+        s = -s;
+      }
+    }
+    a -= n;
+  }
+  return n == 1 ? s : 0;
+}
+
+/**
+ *  @brief Return the Jacobi symbol `(a / n)`.
+ *  @throw `std::invalid_argument` if `n` is not odd and positive.
+ */
+int h_::jacobi(const bi_t& a, const bi_t& n) {
+  if (n.negative() || n.even()) {
+    throw std::invalid_argument("Jacobi symbol requires an odd positive n.");
+  }
+
+  bi_t u = a;
+  bi_t v = n;
+  div_inplace(u, v, true);
+  if (u.negative()) {
+    rem_complement(u, v, false);
+  }
+
+  int s = 1;
+  while (v.size() > 1) {
+    if (u.size() == 0) {
+      return 0;
+    }
+
+    const bi_bitcount_t z = trailing_zeros(u);
+    right_shift(u, u, z);
+    if (z % 2 != 0 && ((v[0] & 7) == 3 || (v[0] & 7) == 5)) {
+      s = -s;
+    }
+
+    if ((u[0] & v[0] & 3) == 3) {
+      s = -s;
+    }
+    u.swap(v);
+    div_inplace(u, v, true);
+  }
+
+  return jacobi_digit(u.size() != 0 ? u[0] : 0, v[0], s);
+}
+
+/**
+ *  @brief Return the Kronecker symbol `(a / n)`, which extends the Jacobi
+ *  symbol to all `n`.
+ */
+int h_::kronecker(const bi_t& a, const bi_t& n) {
+  if (n.size() == 0) {
+    return a.size() == 1 && a[0] == 1 ? 1 : 0;
+  }
+
+  // (a / -1) is -1 for negative a
+  int s = n.negative() && a.negative() ? -1 : 1;
+
+  // (a / 2) is 0 for even a, and -1 for a = 3, 5 (mod 8)
+  const bi_bitcount_t z = trailing_zeros(n);
+  if (z != 0) {
+    if (a.even()) {
+      return 0;
+    }
+    const digit a_mod8 = a.mod_ui(8);
+    if (z % 2 != 0 && (a_mod8 == 3 || a_mod8 == 5)) {
+      s = -s;
+    }
+  }
+
+  bi_t n_odd;
+  right_shift(n_odd, n, z);
+  n_odd.negative_ = false;
+  return s * jacobi(a, n_odd);
+}
+
+/**
+ *  @internal
+ *  @page sqrtmod Square Root Modulo a Prime
+ *  @ingroup algorithms
+ *  For an odd prime \f$ p \f$ and a quadratic residue \f$ a \f$ (Cohen,
+ *  Algorithm 1.5.1 and the remarks following it):
+ *  - If \f$ p \equiv 3 \pmod{4} \f$, \f$ x = a^{(p+1)/4} \f$.
+ *  - If \f$ p \equiv 5 \pmod{8} \f$ (Atkin), with
+ *    \f$ v = (2a)^{(p-5)/8} \f$ and \f$ i = 2av^{2} \f$ (a square root of
+ *    \f$ -1 \f$), \f$ x = av(i - 1) \f$.
+ *  - Otherwise (Tonelli-Shanks), write \f$ p - 1 = 2^{e}q \f$ with odd
+ *    \f$ q \f$ and find a non-residue \f$ z \f$. Start from
+ *    \f$ x = a^{(q+1)/2} \f$, \f$ t = a^{q} \f$ and \f$ c = z^{q} \f$, whose
+ *    order is \f$ 2^{e} \f$. While \f$ t \neq 1 \f$, find the least \f$ i \f$
+ *    with \f$ t^{2^{i}} = 1 \f$, and set \f$ b = c^{2^{e-i-1}} \f$,
+ *    \f$ x \leftarrow xb \f$, \f$ t \leftarrow tb^{2} \f$,
+ *    \f$ c \leftarrow b^{2} \f$ and \f$ e \leftarrow i \f$.
+ *
+ *  Both exponentiations of \f$ a \f$ come from a single one:
+ *  \f$ w = a^{(q-1)/2} \f$ gives \f$ x = aw \f$ and \f$ t = xw \f$.
+ *  @endinternal
+ */
+/**
+ *  @brief Performs `result = x`, where `x * x = a (mod p)` and `0 <= x <=
+ *  p / 2`, for an odd prime `p`.
+ *  @throw `std::invalid_argument` if `p` is not odd and positive, if `a` is
+ *  not a square modulo `p`, or if the search for a non-residue modulo `p`
+ *  fails (only for some composite `p`).
+ */
+void h_::sqrtmod(bi_t& result, const bi_t& a, const bi_t& p) {
+  if (jacobi(a, p) == -1) {
+    throw std::invalid_argument("Not a quadratic residue.");
+  }
+
+  bi_t x = a;
+  div_inplace(x, p, true);
+  if (x.negative()) {
+    rem_complement(x, p, false);
+  }
+  if (x.size() == 0 || (p.size() == 1 && p[0] == 1)) {
+    result = 0;
+    return;
+  }
+  const bi_t a_red = x;
+  const digit p_mod8 = p.mod_ui(8);
+
+  bi_t t, u;
+  if (p_mod8 % 4 == 3) {
+    powmod(x, a_red, (p + 1) >> 2, p);
+  } else if (p_mod8 == 5) {
+    bi_t two_a = a_red << 1;
+    div_inplace(two_a, p, true);
+    bi_t v;
+    powmod(v, two_a, (p - 5) >> 3, p);
+    mulmod(t, v, v, p);
+    mulmod(u, two_a, t, p);  // i = 2av^2
+    u -= 1;
+    if (u.negative()) {
+      u += p;
+    }
+    mulmod(t, a_red, v, p);
+    mulmod(x, t, u, p);
+  } else {
+    const bi_t p_minus_1 = p - 1;
+    const bi_bitcount_t e = trailing_zeros(p_minus_1);
+    const bi_t q = p_minus_1 >> e;
+
+    // Every z < p is a square modulo an odd square p, e.g. 9
+    bi_t z = 2;
+    while (jacobi(z, p) != -1) {
+      if (++z >= p) {
+        throw std::invalid_argument("No quadratic non-residue modulo p.");
+      }
+    }
+    bi_t c;
+    powmod(c, z, q, p);
+
+    bi_t w;
+    powmod(w, a_red, q >> 1, p);
+    mulmod(x, a_red, w, p);  // a^{(q+1)/2}
+    mulmod(t, x, w, p);      // a^{q}
+
+    bi_bitcount_t m = e;
+    while (t != 1) {
+      bi_bitcount_t i = 0;
+      u = t;
+      while (u != 1) {
+        mulmod(w, u, u, p);
+        u.swap(w);
+        if (++i == m) {
+          throw std::invalid_argument("Not a quadratic residue.");
+        }
+      }
+
+      bi_t b = c;
+      for (bi_bitcount_t j = 0; j + i + 1 < m; ++j) {
+        mulmod(w, b, b, p);
+        b.swap(w);
+      }
+      mulmod(w, x, b, p);
+      x.swap(w);
+      mulmod(c, b, b, p);
+      mulmod(w, t, c, p);
+      t.swap(w);
+      m = i;
+    }
+  }
+
+  // The smaller of the two roots
+  bi_t other = p - x;
+  if (other < x) {
+    x.swap(other);
+  }
+  result.swap(x);
+}
+
+///@}
+
 bi_t h_::random_(bi_bitcount_t z) {
   bi_t result{};
 
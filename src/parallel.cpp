@@ -0,0 +1,90 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#if defined(BI_HAVE_LIBNUMA)
+#include <numa.h>
+#include <sched.h>
+#endif
+
+namespace bi::parallel {
+
+namespace {
+
+/**
+ *  Return the IDs of the NUMA nodes this process may run on, or an empty list
+ *  if libnuma is unavailable or the machine is not NUMA.
+ */
+const std::vector<int>& nodes() {
+  static const std::vector<int> ids = []() {
+    std::vector<int> result;
+#if defined(BI_HAVE_LIBNUMA)
+    if (numa_available() < 0) {
+      return result;
+    }
+    bitmask* allowed = numa_get_run_node_mask();
+    for (int node = 0; node <= numa_max_node(); ++node) {
+      if (numa_bitmask_isbitset(allowed, node) != 0) {
+        result.push_back(node);
+      }
+    }
+    numa_bitmask_free(allowed);
+    if (result.size() == 1) {
+      result.clear();
+    }
+#endif
+    return result;
+  }();
+  return ids;
+}
+
+}  // namespace
+
+/// Return the number of NUMA nodes this process may run on (at least one).
+size_t node_count() noexcept {
+  try {
+    return std::max<size_t>(1, nodes().size());
+  } catch (...) {
+    return 1;
+  }
+}
+
+/// Return the index of the NUMA node the calling thread runs on.
+size_t current_node() noexcept {
+#if defined(BI_HAVE_LIBNUMA)
+  if (node_count() > 1) {
+    const int cpu = sched_getcpu();
+    const int node = cpu < 0 ? -1 : numa_node_of_cpu(cpu);
+    const std::vector<int>& ids = nodes();
+    for (size_t i = 0; i < ids.size(); ++i) {
+      if (ids[i] == node) {
+        return i;
+      }
+    }
+  }
+#endif
+  return 0;
+}
+
+/**
+ *  Restrict the calling thread to the CPUs of NUMA node `node`, and have it
+ *  allocate memory on that node. Without libnuma, or for a node that does not
+ *  exist, this does nothing.
+ */
+void bind_to_node([[maybe_unused]] size_t node) noexcept {
+#if defined(BI_HAVE_LIBNUMA)
+  // node_count() first, as it does not throw
+  if (node_count() > 1 && node < nodes().size()) {
+    numa_run_on_node(nodes()[node]);
+    numa_set_localalloc();
+  }
+#endif
+}
+
+}  // namespace bi::parallel
@@ -0,0 +1,131 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef BI_SRC_PARALLEL_HPP_
+#define BI_SRC_PARALLEL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bi::parallel {
+
+/// Return the number of threads that parallel loops use (at least one).
+inline size_t max_threads() noexcept {
+  static const size_t n =
+      std::max<size_t>(1, std::thread::hardware_concurrency());
+  return n;
+}
+
+/// Return a reference to the flag that marks threads running a parallel loop.
+inline bool& in_parallel_region() noexcept {
+  thread_local bool flag = false;
+  return flag;
+}
+
+// NUMA nodes, indexed from 0 among the nodes this process may run on; see
+// parallel.cpp
+size_t node_count() noexcept;
+size_t current_node() noexcept;
+void bind_to_node(size_t node) noexcept;
+
+/**
+ *  Call `f(i)` for each `i` in `[0, n)` over at most `threads` threads (one of
+ *  which is the calling thread), in `nodes` worker groups. Loops nested in a
+ *  parallel loop run serially on the thread that reaches them, so that
+ *  recursive algorithms do not oversubscribe the machine. If calls of `f`
+ *  throw, the remaining indices are skipped and the first exception is
+ *  rethrown once all threads have finished.
+ *
+ *  The indices are split into one contiguous range per group, and the threads
+ *  of a group, which run on its NUMA node, take the indices of its range
+ *  dynamically before helping with the ranges of the other groups. Data that
+ *  `f(i)` allocates is thus first touched, and placed, on the node of the
+ *  group of `i`, and neighbouring indices share a node. The calling thread is
+ *  not moved; it joins the group of the node it runs on.
+ */
+template <typename F>
+void for_each_index_on_nodes(size_t n, F&& f, size_t threads, size_t nodes) {
+  threads = std::min(threads, n);
+  if (threads <= 1 || in_parallel_region()) {
+    for (size_t i = 0; i < n; ++i) {
+      f(i);
+    }
+    return;
+  }
+  nodes = std::clamp<size_t>(nodes, 1, threads);
+
+  // Range g is [next[g], n * (g + 1) / nodes)
+  std::vector<std::atomic<size_t>> next(nodes);
+  for (size_t g = 0; g < nodes; ++g) {
+    next[g] = n * g / nodes;
+  }
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  const auto work = [&](size_t group) {
+    in_parallel_region() = true;
+    try {
+      for (size_t h = 0; h < nodes; ++h) {
+        const size_t g = (group + h) % nodes;
+        const size_t end = n * (g + 1) / nodes;
+        for (size_t i = next[g]++; i < end; i = next[g]++) {
+          f(i);
+        }
+      }
+    } catch (...) {
+      for (size_t g = 0; g < nodes; ++g) {
+        next[g] = n;
+      }
+      const std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+    in_parallel_region() = false;
+  };
+
+  const size_t home = current_node() % nodes;
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  try {
+    for (size_t t = 1; t < threads; ++t) {
+      const size_t group = (home + t) % nodes;
+      workers.emplace_back([&work, group, nodes]() {
+        if (nodes > 1) {
+          bind_to_node(group);
+        }
+        work(group);
+      });
+    }
+  } catch (...) {
+    // Could not start a thread; the threads that did start and this one
+    // still cover all indices
+  }
+  work(home);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+/// Call `f(i)` for each `i` in `[0, n)`, over the NUMA nodes of the machine.
+/// See `for_each_index_on_nodes()`.
+template <typename F>
+void for_each_index(size_t n, F&& f, size_t threads = max_threads()) {
+  for_each_index_on_nodes(n, std::forward<F>(f), threads, node_count());
+}
+
+}  // namespace bi::parallel
+
+#endif  // BI_SRC_PARALLEL_HPP_
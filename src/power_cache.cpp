@@ -0,0 +1,267 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#include "power_cache.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace bi {
+
+namespace {
+
+using power = power_cache::power;
+
+// Threads beyond this many read through the mutex
+constexpr size_t hazard_count = 128;
+
+/// A cached power. Readers copy `value`, so that it outlives eviction.
+struct node {
+  power value;
+};
+
+/**
+ *  The cached powers of each base form a prefix \f$ b^{2^{0}}, \ldots,
+ *  b^{2^{n-1}} \f$, each computed by squaring the one below it. `mutex`
+ *  serializes the writers that extend and evict prefixes.
+ *
+ *  Readers do not lock. A reader publishes the node it is about to copy in
+ *  its *hazard pointer* and then checks that the node is still in its slot;
+ *  a writer that evicts a node only deletes it once no hazard pointer refers
+ *  to it, and keeps it in `retired` until then.
+ */
+struct table {
+  std::array<std::array<std::atomic<node*>, power_cache::max_levels>,
+             power_cache::max_base + 1>
+      slots{};
+  // Length of the cached prefix of each base
+  std::array<unsigned, power_cache::max_base + 1> levels{};
+  // Clock reading of the last access of each base
+  std::array<std::atomic<uint64_t>, power_cache::max_base + 1> last_use{};
+  std::atomic<uint64_t> clock{0};
+  // Bytes held by cached powers, and their limit
+  std::atomic<size_t> usage{0};
+  std::atomic<size_t> limit{power_cache::default_limit};
+
+  std::array<std::atomic<const node*>, hazard_count> hazards{};
+  std::array<std::atomic<bool>, hazard_count> hazard_owned{};
+  // Evicted nodes that a hazard pointer may refer to
+  std::vector<node*> retired;
+
+  std::mutex mutex;
+};
+
+table& instance() {
+  // Never destroyed, so that the cache may be used during static destruction
+  static table* const t = new table;
+  return *t;
+}
+
+/// The hazard pointer of a thread, if one was free when the thread asked.
+class hazard_slot {
+ public:
+  explicit hazard_slot(table& t) noexcept {
+    for (size_t i = 0; i < hazard_count; ++i) {
+      if (!t.hazard_owned[i].exchange(true)) {
+        owned_ = &t.hazard_owned[i];
+        hazard_ = &t.hazards[i];
+        break;
+      }
+    }
+  }
+  hazard_slot(const hazard_slot&) = delete;
+  hazard_slot& operator=(const hazard_slot&) = delete;
+  ~hazard_slot() {
+    if (owned_ != nullptr) {
+      owned_->store(false);
+    }
+  }
+
+  std::atomic<const node*>* get() const noexcept { return hazard_; }
+
+ private:
+  std::atomic<bool>* owned_ = nullptr;
+  std::atomic<const node*>* hazard_ = nullptr;
+};
+
+std::atomic<const node*>* thread_hazard(table& t) {
+  thread_local hazard_slot slot(t);
+  return slot.get();
+}
+
+size_t bytes_of(const bi_t& x) noexcept { return x.capacity() * sizeof(digit); }
+
+/// Delete the retired nodes that no hazard pointer refers to. The caller
+/// holds the mutex.
+void reclaim(table& t) {
+  std::erase_if(t.retired, [&t](node* n) {
+    for (const std::atomic<const node*>& hazard : t.hazards) {
+      if (hazard.load() == n) {
+        return false;
+      }
+    }
+    delete n;  // NOLINT(cppcoreguidelines-owning-memory)
+    return true;
+  });
+}
+
+/**
+ *  Evict the largest power of the least recently used base, other than
+ *  `keep`, that has powers cached. Return false if there is none. The caller
+ *  holds the mutex.
+ */
+bool evict_one(table& t, int keep) {
+  int victim = 0;
+  uint64_t oldest = UINT64_MAX;
+  for (int b = power_cache::min_base; b <= power_cache::max_base; ++b) {
+    const uint64_t used = t.last_use[b].load(std::memory_order_relaxed);
+    if (b != keep && t.levels[b] != 0 && used <= oldest) {
+      victim = b;
+      oldest = used;
+    }
+  }
+  if (victim == 0) {
+    return false;
+  }
+
+  const unsigned top = --t.levels[victim];
+  node* n = t.slots[victim][top].exchange(nullptr);
+  t.usage -= bytes_of(*n->value);
+  t.retired.push_back(n);
+  reclaim(t);
+  return true;
+}
+
+/**
+ *  Cache `p` as the power at level `k` of `base`, if it extends the prefix of
+ *  `base` and fits in the limit once other bases' powers are evicted. The
+ *  caller holds the mutex.
+ */
+void admit(table& t, int base, unsigned k, const power& p) {
+  if (t.levels[base] != k) {
+    return;
+  }
+  const size_t bytes = bytes_of(*p);
+  while (t.usage + bytes > t.limit) {
+    if (!evict_one(t, base)) {
+      return;
+    }
+  }
+  t.slots[base][k].store(new node{p});  // NOLINT(*-owning-memory)
+  t.levels[base] = k + 1;
+  t.usage += bytes;
+}
+
+/// Return `base^{2^k}`, computing and caching the missing powers below it.
+power extend(table& t, int base, unsigned k) {
+  unsigned level = 0;
+  power p;
+  {
+    const std::lock_guard<std::mutex> lock(t.mutex);
+    level = t.levels[base];
+    if (level > k) {
+      return t.slots[base][k].load()->value;
+    }
+    if (level != 0) {
+      p = t.slots[base][level - 1].load()->value;
+    }
+  }
+
+  // Square outside of the lock, so that writers of other bases do not wait
+  // for it
+  for (unsigned i = level; i <= k; ++i) {
+    power next = i == 0 ? std::make_shared<const bi_t>(base)
+                        : std::make_shared<const bi_t>(*p * *p);
+    {
+      const std::lock_guard<std::mutex> lock(t.mutex);
+      if (t.levels[base] > i) {
+        // Another thread got here first; share its power
+        next = t.slots[base][i].load()->value;
+      } else {
+        admit(t, base, i, next);
+      }
+    }
+    p = std::move(next);
+  }
+  return p;
+}
+
+}  // namespace
+
+/**
+ *  @brief Return \f$ base^{2^{k}} \f$ for `base` in \f$ [2, 36] \f$.
+ *  @details If the power is cached, this takes no lock. Otherwise, the
+ *  missing powers up to it are computed by repeated squaring and cached, as
+ *  long as the limit allows; when it does not, the powers of the least
+ *  recently used other bases are evicted, largest first, and a power that
+ *  still does not fit is returned without being cached.
+ */
+power_cache::power power_cache::get(int base, unsigned k) {
+  table& t = instance();
+  t.last_use[base].store(t.clock.fetch_add(1, std::memory_order_relaxed),
+                         std::memory_order_relaxed);
+
+  if (std::atomic<const node*>* hazard = thread_hazard(t)) {
+    const std::atomic<node*>& slot = t.slots[base][k];
+    const node* n = slot.load();
+    while (n != nullptr) {
+      hazard->store(n);
+      const node* again = slot.load();
+      if (again == n) {
+        break;
+      }
+      n = again;
+    }
+    power p = n != nullptr ? n->value : nullptr;
+    hazard->store(nullptr);
+    if (p) {
+      return p;
+    }
+  }
+  return extend(t, base, k);
+}
+
+/**
+ *  @brief Return \f$ base^{exp} \f$ for `base` in \f$ [2, 36] \f$, as the
+ *  product of the cached powers \f$ base^{2^{k}} \f$ for the set bits `k` of
+ *  `exp`.
+ */
+bi_t power_cache::pow(int base, bi_bitcount_t exp) {
+  bi_t result = 1;
+  for (unsigned k = 0; k < max_levels && (exp >> k) != 0; ++k) {
+    if (((exp >> k) & 1) != 0) {
+      result *= *get(base, k);
+    }
+  }
+  return result;
+}
+
+/// Return the limit, in bytes, of the memory held by cached powers.
+size_t power_cache::limit() noexcept { return instance().limit; }
+
+/// Set the limit of the memory held by cached powers, evicting as needed.
+void power_cache::set_limit(size_t bytes) {
+  table& t = instance();
+  const std::lock_guard<std::mutex> lock(t.mutex);
+  t.limit = bytes;
+  while (t.usage > t.limit && evict_one(t, 0)) {
+  }
+}
+
+/// Return the memory, in bytes, held by cached powers.
+size_t power_cache::usage() noexcept { return instance().usage; }
+
+/// Evict all cached powers.
+void power_cache::clear() {
+  table& t = instance();
+  const std::lock_guard<std::mutex> lock(t.mutex);
+  while (evict_one(t, 0)) {
+  }
+}
+
+}  // namespace bi
@@ -0,0 +1,42 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef BI_SRC_POWER_CACHE_HPP_
+#define BI_SRC_POWER_CACHE_HPP_
+
+#include <cstddef>
+#include <memory>
+
+#include "bi.hpp"
+
+namespace bi {
+
+/**
+ *  Process-wide cache of the powers \f$ b^{2^{k}} \f$ of the bases
+ *  \f$ b \in [2, 36] \f$, which radix conversions and powers of small bases
+ *  share. See power_cache.cpp.
+ */
+class power_cache {
+ public:
+  using power = std::shared_ptr<const bi_t>;
+
+  static constexpr int min_base = 2;
+  static constexpr int max_base = 36;
+  // Levels k of b^{2^k}; b^{2^64} exceeds any bi_t
+  static constexpr unsigned max_levels = 64;
+  static constexpr size_t default_limit = size_t{64} << 20;
+
+  static power get(int base, unsigned k);
+  static bi_t pow(int base, bi_bitcount_t exp);
+
+  static size_t limit() noexcept;
+  static void set_limit(size_t bytes);
+  static size_t usage() noexcept;
+  static void clear();
+};
+
+}  // namespace bi
+
+#endif  // BI_SRC_POWER_CACHE_HPP_
@@ -0,0 +1,78 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+#ifndef BI_SRC_ROUNDING_HPP_
+#define BI_SRC_ROUNDING_HPP_
+
+#include <utility>
+
+#include "bi.hpp"
+
+namespace bi {
+
+/**
+ *  @brief Decide whether a truncated result should be incremented in
+ *  magnitude to round it according to `mode`.
+ *
+ *  @param mode The rounding mode.
+ *  @param negative Whether the exact result is negative.
+ *  @param odd Whether the truncated magnitude is odd.
+ *  @param half The discarded fraction compared with one half: negative if it
+ *  is less, zero if it is equal, positive if it is greater.
+ *  @param inexact Whether the discarded fraction is nonzero.
+ */
+constexpr bool round_away(rounding mode, bool negative, bool odd, int half,
+                          bool inexact) noexcept {
+  if (!inexact) {
+    return false;
+  }
+
+  switch (mode) {
+    case rounding::half_even:
+      return half > 0 || (half == 0 && odd);
+    case rounding::half_away_from_zero:
+      return half >= 0;
+    case rounding::half_toward_zero:
+      return half > 0;
+    case rounding::toward_zero:
+      return false;
+    case rounding::away_from_zero:
+      return true;
+    case rounding::floor:
+      return negative;
+    case rounding::ceil:
+      return !negative;
+  }
+
+  return false;
+}
+
+/// Return `num / den` rounded to an integer according to `mode`.
+inline bi_t div_round(const bi_t& num, const bi_t& den, rounding mode) {
+  auto [quot, rem] = num.div(den);
+  if (rem.sign() == 0) {
+    return std::move(quot);
+  }
+
+  // |rem| < |den|, so compare 2|rem| with |den| to locate the fraction
+  const bi_t twice_rem = abs(rem) << 1;
+  const auto cmp = den.negative() ? twice_rem <=> -den : twice_rem <=> den;
+  const int half = cmp < 0 ? -1 : (cmp > 0 ? 1 : 0);
+  const bool negative = num.negative() != den.negative();
+
+  if (round_away(mode, negative, quot.odd(), half, true)) {
+    if (negative) {
+      --quot;
+    } else {
+      ++quot;
+    }
+  }
+
+  return std::move(quot);
+}
+
+}  // namespace bi
+
+#endif  // BI_SRC_ROUNDING_HPP_
@@ -6,6 +6,7 @@ SPDX-License-Identifier: Apache-2.0
 #ifndef BI_SRC_UINTS_HPP_
 #define BI_SRC_UINTS_HPP_
 
+#include <algorithm>
 #include <climits>
 #include <concepts>
 #include <cstddef>
@@ -13,6 +14,23 @@ SPDX-License-Identifier: Apache-2.0
 #include <limits>
 #include <utility>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+#define BI_UINTS_X86_ADDCARRY
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_addc) && __has_builtin(__builtin_addcll) && \
+    __has_builtin(__builtin_subc) && __has_builtin(__builtin_subcll)
+#define BI_UINTS_HAS_ADDC 1
+#endif
+#endif
+#ifndef BI_UINTS_HAS_ADDC
+#define BI_UINTS_HAS_ADDC 0
+#endif
+
 namespace uints {
 
 template <std::unsigned_integral T, std::integral U = bool>
@@ -79,6 +97,165 @@ std::pair<T, bool> umul_overflow(T a, T b) noexcept {
   return {r, a && r / a != b};
 }
 
+/**
+ *  @brief Set `r = a + b + carry` and return the carry out, where `carry` is 0
+ *  or 1.
+ *  @details Uses the `_addcarry_u32`/`_addcarry_u64` intrinsics on x86-64 and
+ *  `__builtin_addc`/`__builtin_addcll` elsewhere where available. These
+ *  compile to `adc` (or its equivalent), so that a chain of calls keeps the
+ *  carry in the carry flag instead of recomputing it with comparisons.
+ */
+template <std::unsigned_integral T>
+inline unsigned char addcarry(unsigned char carry, T a, T b, T& r) noexcept {
+#if defined(BI_UINTS_X86_ADDCARRY)
+  if constexpr (sizeof(T) == sizeof(unsigned long long)) {  // NOLINT
+    unsigned long long out;                                 // NOLINT
+    carry = _addcarry_u64(carry, a, b, &out);
+    r = static_cast<T>(out);
+    return carry;
+  } else if constexpr (sizeof(T) == sizeof(unsigned int)) {
+    unsigned int out;
+    carry = _addcarry_u32(carry, a, b, &out);
+    r = static_cast<T>(out);
+    return carry;
+  }
+#elif BI_UINTS_HAS_ADDC
+  if constexpr (sizeof(T) == sizeof(unsigned long long)) {  // NOLINT
+    unsigned long long out;                                 // NOLINT
+    r = static_cast<T>(__builtin_addcll(a, b, carry, &out));
+    return static_cast<unsigned char>(out);
+  } else if constexpr (sizeof(T) == sizeof(unsigned int)) {
+    unsigned int out;
+    r = static_cast<T>(__builtin_addc(a, b, carry, &out));
+    return static_cast<unsigned char>(out);
+  }
+#endif
+  bool c = carry;
+  uaddc(r, a, b, c);
+  return c;
+}
+
+/**
+ *  @brief Set `r = a - b - borrow` and return the borrow out, where `borrow`
+ *  is 0 or 1. Counterpart of `addcarry()` with `sbb`.
+ */
+template <std::unsigned_integral T>
+inline unsigned char subborrow(unsigned char borrow, T a, T b, T& r) noexcept {
+#if defined(BI_UINTS_X86_ADDCARRY)
+  if constexpr (sizeof(T) == sizeof(unsigned long long)) {  // NOLINT
+    unsigned long long out;                                 // NOLINT
+    borrow = _subborrow_u64(borrow, a, b, &out);
+    r = static_cast<T>(out);
+    return borrow;
+  } else if constexpr (sizeof(T) == sizeof(unsigned int)) {
+    unsigned int out;
+    borrow = _subborrow_u32(borrow, a, b, &out);
+    r = static_cast<T>(out);
+    return borrow;
+  }
+#elif BI_UINTS_HAS_ADDC
+  if constexpr (sizeof(T) == sizeof(unsigned long long)) {  // NOLINT
+    unsigned long long out;                                 // NOLINT
+    r = static_cast<T>(__builtin_subcll(a, b, borrow, &out));
+    return static_cast<unsigned char>(out);
+  } else if constexpr (sizeof(T) == sizeof(unsigned int)) {
+    unsigned int out;
+    r = static_cast<T>(__builtin_subc(a, b, borrow, &out));
+    return static_cast<unsigned char>(out);
+  }
+#endif
+  bool b_out = borrow;
+  usubb(r, a, b, b_out);
+  return b_out;
+}
+
+/**
+ *  @brief Set `r[0..n) = a[0..n) + b[0..n)` and return the carry out. `r` may
+ *  be `a` or `b`.
+ *  @details The loop is unrolled by four digits, which leaves the carry chain
+ *  as the only dependency between iterations.
+ */
+template <std::unsigned_integral T>
+T add_n(T* r, const T* a, const T* b, size_t n) noexcept {
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  unsigned char carry = 0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    carry = addcarry(carry, a[i], b[i], r[i]);
+    carry = addcarry(carry, a[i + 1], b[i + 1], r[i + 1]);
+    carry = addcarry(carry, a[i + 2], b[i + 2], r[i + 2]);
+    carry = addcarry(carry, a[i + 3], b[i + 3], r[i + 3]);
+  }
+  for (; i < n; ++i) {
+    carry = addcarry(carry, a[i], b[i], r[i]);
+  }
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  return carry;
+}
+
+/**
+ *  @brief Set `r[0..n) = a[0..n) - b[0..n)` and return the borrow out. `r` may
+ *  be `a` or `b`.
+ */
+template <std::unsigned_integral T>
+T sub_n(T* r, const T* a, const T* b, size_t n) noexcept {
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  unsigned char borrow = 0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    borrow = subborrow(borrow, a[i], b[i], r[i]);
+    borrow = subborrow(borrow, a[i + 1], b[i + 1], r[i + 1]);
+    borrow = subborrow(borrow, a[i + 2], b[i + 2], r[i + 2]);
+    borrow = subborrow(borrow, a[i + 3], b[i + 3], r[i + 3]);
+  }
+  for (; i < n; ++i) {
+    borrow = subborrow(borrow, a[i], b[i], r[i]);
+  }
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  return borrow;
+}
+
+/**
+ *  @brief Set `r[0..n) = a[0..n) + carry` and return the carry out, where
+ *  `carry` is 0 or 1. Once the carry is absorbed, the remaining digits are
+ *  copied (unless `r` is `a`).
+ */
+template <std::unsigned_integral T>
+T add_1(T* r, const T* a, size_t n, T carry) noexcept {
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  size_t i = 0;
+  for (; carry != 0 && i < n; ++i) {
+    r[i] = a[i] + 1;
+    carry = r[i] == 0;
+  }
+  if (r != a) {
+    std::copy(a + i, a + n, r + i);
+  }
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  return carry;
+}
+
+/**
+ *  @brief Set `r[0..n) = a[0..n) - borrow` and return the borrow out, where
+ *  `borrow` is 0 or 1. Once the borrow is absorbed, the remaining digits are
+ *  copied (unless `r` is `a`).
+ */
+template <std::unsigned_integral T>
+T sub_1(T* r, const T* a, size_t n, T borrow) noexcept {
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  size_t i = 0;
+  for (; borrow != 0 && i < n; ++i) {
+    const T x = a[i];
+    r[i] = x - 1;
+    borrow = x == 0;
+  }
+  if (r != a) {
+    std::copy(a + i, a + n, r + i);
+  }
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  return borrow;
+}
+
 /**
  *  @brief Return the number of bits required to represent a value of type T,
  *  where T is an unsigned integral type.
@@ -171,6 +348,58 @@ constexpr bool has_double_exact(T value) noexcept {
   return value <= dbl_max_int;
 }
 
+/**
+ *  Return the inverse of odd `a` modulo 2 ** width, i.e. the `x` with `a * x`
+ *  equal to 1 in type T. Newton's iteration `x <- x * (2 - a * x)` doubles the
+ *  number of correct low bits, starting from `x = a`, which is correct to
+ *  three bits since `a * a = 1 (mod 8)` for every odd `a`.
+ */
+template <std::unsigned_integral T>
+constexpr T inverse_mod_pow2(T a) noexcept {
+  constexpr unsigned width = std::numeric_limits<T>::digits;
+
+  T x = a;
+  for (unsigned bits = 3; bits < width; bits *= 2) {
+    x = static_cast<T>(x * static_cast<T>(2 - a * x));
+  }
+  return x;
+}
+
+/**
+ *  Return the inverse of `a` modulo `m > 0`, i.e. the `x` in `[0, m)` with
+ *  `a * x = 1 (mod m)`, or 0 if `gcd(a, m) != 1` or `m == 1`.
+ *
+ *  Extended Euclid on unsigned values: with `u_0 = m, u_1 = a mod m, x_0 = 0,
+ *  x_1 = 1` and `u_{k+1} = u_{k-1} - q u_{k}, x_{k+1} = x_{k-1} + q x_{k}`, the
+ *  invariant `u_{k} = (-1)^{k+1} x_{k} a (mod m)` holds, and the `x_{k}` never
+ *  exceed `m`.
+ */
+template <std::unsigned_integral T>
+constexpr T inverse_mod(T a, T m) noexcept {
+  if (m == 1) {
+    return 0;
+  }
+
+  T u0 = m, u1 = a % m;
+  T x0 = 0, x1 = 1;
+  bool odd = false;  // parity of the index of u0
+  while (u1 != 0) {
+    const T q = u0 / u1;
+    const T u2 = u0 - q * u1;
+    const T x2 = x0 + q * x1;
+    u0 = u1;
+    u1 = u2;
+    x0 = x1;
+    x1 = x2;
+    odd = !odd;
+  }
+
+  if (u0 != 1) {
+    return 0;
+  }
+  return odd ? x0 : m - x0;
+}
+
 template <std::unsigned_integral T, std::unsigned_integral U>
 constexpr T div_ceil(T x, U y) {
   return x == 0 ? 0 : 1 + (x - 1) / y;
@@ -0,0 +1,278 @@
+/*
+Copyright 2024 Owain Davies
+SPDX-License-Identifier: Apache-2.0
+*/
+
+// Runs the operations of the library from many threads at once, to check the
+// concurrency contract of bi_t (see its documentation): `const` operations on
+// shared integers may run concurrently, and so may modifications of distinct
+// integers. Build with -DBI_SANITIZE_THREAD=ON to run it under ThreadSanitizer.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <compare>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bi.hpp"
+#include "bi_accumulator.hpp"
+#include "bi_crt.hpp"
+#include "bi_decimal.hpp"
+#include "bi_intern.hpp"
+#include "bi_matrix.hpp"
+#include "bi_rational.hpp"
+#include "power_cache.hpp"
+
+namespace {
+
+using bi::bi_t;
+using bi::digit;
+
+/// Return `std::thread::hardware_concurrency()`, but at least 4.
+size_t thread_count() {
+  return std::max<size_t>(4, std::thread::hardware_concurrency());
+}
+
+/// Return a random integer of `n` digits, negative if `negative`.
+bi_t random_integer(std::mt19937& rng, size_t n, bool negative) {
+  std::uniform_int_distribution<digit> dist;
+  bi_t x;
+  for (size_t i = 0; i < n; ++i) {
+    x <<= std::numeric_limits<digit>::digits;
+    x += dist(rng);
+  }
+  return negative ? -x : x;
+}
+
+/// Integers of sizes on both sides of the thresholds of the algorithms.
+std::vector<bi_t> make_operands() {
+  std::mt19937 rng(2024);  // NOLINT(cert-msc51-cpp)
+  std::vector<bi_t> operands = {0, 1, -1, 7, bi_t(1) << 100};
+  for (const size_t n : {1, 2, 5, 40, 90, 300}) {
+    operands.push_back(random_integer(rng, n, false));
+    operands.push_back(random_integer(rng, n, true));
+  }
+  return operands;
+}
+
+/// The results of the operations on a pair of integers.
+struct outcome {
+  std::vector<bi_t> values;
+  std::vector<std::string> strings;
+  std::vector<int> flags;
+
+  bool operator==(const outcome&) const = default;
+};
+
+/// Apply the operations of the library to the shared integers `a` and `b`.
+outcome run(const bi_t& a, const bi_t& b) {
+  outcome out;
+  std::vector<bi_t>& v = out.values;
+
+  // Arithmetic
+  v.push_back(a + b);
+  v.push_back(a - b);
+  v.push_back(a * b);
+  v.push_back(a * a);
+  v.push_back(-a);
+  v.push_back(bi::abs(a));
+  if (b != 0) {
+    v.push_back(a / b);
+    v.push_back(a % b);
+    const auto [q, r] = a.div(b);
+    v.push_back(q);
+    v.push_back(r);
+    v.push_back(bi::div_floor(a, b));
+    v.push_back(bi::div_ceil(a, b));
+    v.push_back(bi::mod_euclid(a, b));
+  }
+  v.push_back(bi::mul_low(a, b, 3));
+  v.push_back(bi::mul_high(a, b, 3));
+  v.push_back(bi::gcd(a, b));
+  v.push_back(bi_t::pow(a, 3));
+  v.push_back(bi_t::pow(10, 700 + b.bit_length()));
+  v.push_back(bi_t::pow(3, 50 + a.bit_length()));
+  v.push_back(bi::powmod(a, bi::abs(b), (bi_t(1) << 127) - 1));
+  v.push_back(a.mod_ui(1000003));
+
+  // Bits
+  v.push_back(a << 77);
+  v.push_back(a >> 33);
+  v.push_back(a & b);
+  v.push_back(a | b);
+  v.push_back(a ^ b);
+  v.push_back(~a);
+
+  // Comparisons and conversions
+  out.flags.push_back(static_cast<int>((a <=> b) == 0) +
+                      2 * static_cast<int>((a <=> b) < 0));
+  out.flags.push_back(static_cast<int>(a.is_pow2()));
+  out.flags.push_back(static_cast<int>(a.bit_length()));
+  out.flags.push_back(static_cast<int>(bi::hash_value(a) % 1000));
+  if (a.bit_length() < 1000) {
+    v.push_back(bi_t(a.to_double()));
+  }
+  for (const int base : {2, 7, 10, 16, 36}) {
+    out.strings.push_back(a.to_string(base));
+    v.push_back(bi_t(out.strings.back(), base));
+  }
+
+  // Other modules
+  bi::accumulator acc;
+  acc += a;
+  acc -= b;
+  v.push_back(acc.value());
+  v.push_back(bi::sum(std::vector<bi_t>{a, b, a}));
+  v.push_back(*bi::intern(a));
+  out.flags.push_back(static_cast<int>(bi::intern(a) == bi::intern(bi_t(a))));
+  const std::vector<digit> moduli = {1000003, 1000033, 1000037};
+  v.push_back(bi::crt(bi::multi_mod(a, moduli), moduli));
+  if (b != 0) {
+    out.strings.push_back(bi::rational(a, b).to_string());
+  }
+  out.strings.push_back(bi::decimal(a, -5).to_string());
+  const bi::matrix m = {{a, b}, {b, a}};
+  const bi::matrix square = m * m;
+  v.push_back(square(0, 0));
+  v.push_back(square(0, 1));
+
+  // Modifications of integers that only this thread sees
+  bi_t x = a;
+  x += b;
+  x *= b;
+  x -= a;
+  x <<= 5;
+  x >>= 3;
+  ++x;
+  bi::addmul(x, a, b);
+  x.mod_pow2(200);
+  v.push_back(x);
+
+  return out;
+}
+
+TEST(Stress, SharedConstOperands) {
+  const std::vector<bi_t> operands = make_operands();
+
+  std::vector<outcome> expected;
+  for (const bi_t& a : operands) {
+    for (const bi_t& b : operands) {
+      expected.push_back(run(a, b));
+    }
+  }
+
+  // Start from an empty power cache, so that the threads race to fill it
+  bi::power_cache::clear();
+
+  const size_t n = thread_count();
+  std::vector<int> mismatches(n, 0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < n; ++t) {
+    threads.emplace_back([&, t]() {
+      // Each thread walks the pairs from a different starting point
+      const size_t pairs = expected.size();
+      for (size_t i = 0; i < pairs; ++i) {
+        const size_t k = (i + t * pairs / n) % pairs;
+        const bi_t& a = operands[k / operands.size()];
+        const bi_t& b = operands[k % operands.size()];
+        if (run(a, b) != expected[k]) {
+          ++mismatches[t];
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(mismatches, std::vector<int>(n, 0));
+}
+
+TEST(Stress, PowerCacheEviction) {
+  // Conversions in several bases read the power cache while one thread keeps
+  // shrinking, growing and clearing it, evicting powers that readers hold
+  std::mt19937 rng(7);  // NOLINT(cert-msc51-cpp)
+  std::vector<bi_t> values;
+  for (int i = 0; i < 6; ++i) {
+    values.push_back(random_integer(rng, 200 + 50 * i, i % 2 == 1));
+  }
+
+  const size_t n = thread_count();
+  std::atomic<bool> done{false};
+  std::vector<int> mismatches(n, 0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < n; ++t) {
+    threads.emplace_back([&, t]() {
+      const int base = 2 + static_cast<int>(t % 35);
+      for (int round = 0; round < 4; ++round) {
+        for (const bi_t& x : values) {
+          if (bi_t(x.to_string(base), base) != x) {
+            ++mismatches[t];
+          }
+        }
+      }
+    });
+  }
+  std::thread evictor([&done]() {
+    const size_t limits[] = {0, 4096, 1 << 16, bi::power_cache::default_limit};
+    for (size_t i = 0; !done; ++i) {
+      bi::power_cache::set_limit(limits[i % 4]);
+      if (i % 5 == 0) {
+        bi::power_cache::clear();
+      }
+      std::this_thread::yield();
+    }
+  });
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  done = true;
+  evictor.join();
+  bi::power_cache::set_limit(bi::power_cache::default_limit);
+
+  EXPECT_EQ(mismatches, std::vector<int>(n, 0));
+  EXPECT_LE(bi::power_cache::usage(), bi::power_cache::limit());
+}
+
+TEST(Stress, DistinctIntegers) {
+  // Each thread modifies its own integers, in place and by assignment
+  const size_t n = thread_count();
+  std::vector<bi_t> results(n);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < n; ++t) {
+    threads.emplace_back([&results, t]() {
+      bi_t x = static_cast<int>(t) + 1;
+      for (int i = 0; i < 200; ++i) {
+        x *= 3;
+        x += i;
+        if (i % 7 == 0) {
+          x /= 2;
+        }
+      }
+      results[t] = std::move(x);
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (size_t t = 0; t < n; ++t) {
+    bi_t x = static_cast<int>(t) + 1;
+    for (int i = 0; i < 200; ++i) {
+      x *= 3;
+      x += i;
+      if (i % 7 == 0) {
+        x /= 2;
+      }
+    }
+    EXPECT_EQ(results[t], x);
+  }
+}
+
+}  // namespace
@@ -6,18 +6,39 @@ SPDX-License-Identifier: Apache-2.0
 #include <gtest/gtest.h>
 
 #include <array>
+#include <atomic>
+#include <cctype>
 #include <charconv>
 #include <cmath>
+#include <cstdlib>
 #include <functional>
 #include <limits>
 #include <numeric>
 #include <random>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
 
 #include "bi.hpp"
+#include "bi_accumulator.hpp"
+#include "bi_bigfloat.hpp"
+#include "bi_crt.hpp"
+#include "bi_decimal.hpp"
+#include "bi_matrix.hpp"
+#include "bi_memory.hpp"
+#include "bi_modint.hpp"
 #include "bi_exceptions.hpp"
+#include "bi_intern.hpp"
+#include "bi_rational.hpp"
 #include "constants.hpp"
 #include "int128.hpp"
+#include "parallel.hpp"
+#include "power_cache.hpp"
 #include "uints.hpp"
 
 namespace bi {
@@ -25,6 +46,7 @@ namespace bi {
 struct h_ {
   static bi_t random_(bi_bitcount_t);
   static void mul_karatsuba(bi_t&, const bi_t&, const bi_t&);
+  static void mul_karatsuba_parallel(bi_t&, const bi_t&, const bi_t&, size_t);
   static void mul_standard(bi_t&, const bi_t&, const bi_t&);
 };
 
@@ -32,6 +54,7 @@ struct h_ {
 
 namespace {
 
+using bi::bi_bitcount_t;
 using bi::bi_dmax;
 using bi::bi_dwidth;
 using bi::bi_t;
@@ -71,6 +94,37 @@ class BITest : public testing::Test {
   void TearDown() override {}
 };
 
+bi::rational to_rational(const bi::bigfloat& x) {
+  const bi_bitcount_t shift =
+      x.exponent() < 0 ? -x.exponent() : x.exponent();
+  if (x.exponent() >= 0) {
+    return bi::rational{x.mantissa() << shift};
+  }
+  return bi::rational{x.mantissa(), bi_t{1} << shift};
+}
+
+// Unit in the last place of the nonzero x, at precision `precision`
+bi::rational ulp(const bi::bigfloat& x, bi_bitcount_t precision) {
+  const int64_t e = x.exponent() +
+                    static_cast<int64_t>(x.mantissa().bit_length()) -
+                    static_cast<int64_t>(precision);
+  const bi_bitcount_t shift = e < 0 ? -e : e;
+  if (e >= 0) {
+    return bi::rational{bi_t{1} << shift};
+  }
+  return bi::rational{1, bi_t{1} << shift};
+}
+
+bi::bigfloat random_bigfloat(std::mt19937& rng, bi_bitcount_t precision) {
+  std::uniform_int_distribution<int64_t> edist(-200, 200);
+  std::uniform_int_distribution<int> sdist(0, 1);
+  bi_t m = bi::h_::random_(precision) + 1;
+  if (sdist(rng)) {
+    m.negate();
+  }
+  return bi::bigfloat{m, edist(rng), precision};
+}
+
 template <typename T>
 std::string integral_type_name() {
   if constexpr (std::is_same_v<T, int>)
@@ -1085,6 +1139,13 @@ TEST_F(BITest, RightShiftAssignment) {
   bi_t c(4);
   c >>= 4;
   EXPECT_EQ(c, 0);
+
+  // Floor division for negative values, in place
+  bi_t d(-6);
+  EXPECT_EQ(d >>= 1, -3);
+  EXPECT_EQ(d >>= 1, -2);
+  d = -(bi_t{1} << 100) - 1;
+  EXPECT_EQ(d >>= 64, -(bi_t{1} << 36) - 1);
 }
 
 TEST_F(BITest, AdditionAssignment) {
@@ -1132,6 +1193,15 @@ TEST_F(BITest, MultiplicationAssignment) {
     EXPECT_EQ(a.to_string(), "-170141183460469231722463931679029329920");
   }
 
+  // Both operands negative
+  bi_t d(-5);
+  d *= bi_t(-3);
+  EXPECT_EQ(d, 15);
+  d = 0;
+  d *= bi_t(-3);
+  EXPECT_EQ(d, 0);
+  EXPECT_FALSE(d.negative());
+
   // Self-multiplication
   bi_t c(7);
   c *= c;
@@ -2103,28 +2173,27 @@ TEST_F(BITest, CompareToDouble) {
   EXPECT_FALSE(one >= nan);
   EXPECT_FALSE(one >= snan);
 
-  // Comparison with infinities above triggers the case where bi_base_dbl <= dbl
-  // in the implementation. Similarly, this does too:
+  // Integers against their conversions to double, which may round up
   EXPECT_TRUE(bi_t{ddigit_max} <= static_cast<double>(ddigit_max));
 
   EXPECT_TRUE(bi_t{sddigit_min} >= static_cast<double>(sddigit_min));
   EXPECT_TRUE(bi_t{sdigit_min} >= static_cast<double>(sdigit_min));
   EXPECT_TRUE(bi_t{digit_max} <= static_cast<double>(digit_max));
 
-  // *it < cur: one iteration (the max_double ones above cover > 1 iteration)
+  // Bit length below the exponent of the double
   EXPECT_TRUE(bi_t{1} << bi_dwidth < std::ldexp(1.0, bi_dwidth + 1));
   EXPECT_TRUE((bi_t{1} << (bi_dwidth * 2)) <
               std::ldexp(1.0, bi_dwidth * 2 + 1));
 
-  // *it > cur: one iteration (the max_double ones above cover > 1 iteration)
+  // Bit length above the exponent of the double
   EXPECT_TRUE(bi_t{1} << (bi_dwidth + 2) > std::ldexp(1.0, bi_dwidth + 1));
   EXPECT_TRUE((bi_t{1} << (bi_dwidth * 2 + 2)) >
               std::ldexp(1.0, bi_dwidth * 2 + 1));
 
-  // Large is the first number possible that will trigger the z.size() >= upper
-  // branch of the impl.
-  constexpr auto upper = bi::bi_cmp_dbl_size_upper;
-  constexpr auto shift = bi::bi_dbits * (upper - 1);  // Should be 1024
+  // Large = 2^1024 is the least integer whose bit length exceeds the exponent
+  // of every finite double
+  constexpr auto shift = std::numeric_limits<double>::max_exponent;
+  static_assert(shift == 1024);
   bi_t large = bi_t{1} << shift;
   if (bi::bi_dbits == 32) {
     EXPECT_EQ(large.size(), 33);
@@ -2133,7 +2202,7 @@ TEST_F(BITest, CompareToDouble) {
   }
   EXPECT_TRUE(large > std::numeric_limits<double>::max());
   EXPECT_TRUE((large + 1) > std::numeric_limits<double>::max());
-  // This will not trigger the z.size() >= upper branch
+  // Same bit length as the largest double; decided by the lower bits
   EXPECT_TRUE((large - 1) > std::numeric_limits<double>::max());
 
   // Misc.
@@ -2332,6 +2401,1918 @@ TEST_F(BITest, Karatsuba) {
   }
 }
 
+TEST_F(BITest, Gcd) {
+  EXPECT_EQ(bi::gcd(0, 0), 0);
+  EXPECT_EQ(bi::gcd(0, -7), 7);
+  EXPECT_EQ(bi::gcd(-12, 18), 6);
+  EXPECT_EQ(bi::gcd(17, 5), 1);
+  EXPECT_EQ(bi::gcd(bi_t{1} << 200, bi_t{1} << 130), bi_t{1} << 130);
+
+  // Consecutive Fibonacci numbers maximize the number of Euclidean steps
+  bi_t f_1 = 1, f_2 = 1;
+  for (int i = 0; i < 500; ++i) {
+    f_1 += f_2;
+    f_1.swap(f_2);
+  }
+  EXPECT_EQ(bi::gcd(f_1, f_2), 1);
+
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  std::uniform_int_distribution<int> dist(1, 12);
+
+  for (int i = 0; i < 200; ++i) {
+    const bi_t g = bi::h_::random_(bi_dwidth * dist(rng)) + 1;
+    const bi_t a = g * bi::h_::random_(bi_dwidth * dist(rng));
+    const bi_t b = -g * bi::h_::random_(bi_dwidth * dist(rng));
+
+    // Euclid's algorithm
+    bi_t u = abs(a), v = abs(b);
+    while (v != 0) {
+      u %= v;
+      u.swap(v);
+    }
+
+    const bi_t result = bi::gcd(a, b);
+    ASSERT_EQ(result, u);
+    ASSERT_EQ(result, bi::gcd(b, a));
+    ASSERT_EQ(result % g, 0);
+  }
+}
+
+TEST_F(BITest, RationalConstruction) {
+  using bi::rational;
+
+  rational zero;
+  EXPECT_EQ(zero.numerator(), 0);
+  EXPECT_EQ(zero.denominator(), 1);
+  EXPECT_TRUE(zero.normalized());
+
+  rational x{6, -4};
+  EXPECT_EQ(x.numerator(), -6);
+  EXPECT_EQ(x.denominator(), 4);
+  EXPECT_FALSE(x.normalized());
+  EXPECT_EQ(x.to_string(), "-3/2");
+  x.normalize();
+  EXPECT_EQ(x.numerator(), -3);
+  EXPECT_EQ(x.denominator(), 2);
+  EXPECT_TRUE(x.normalized());
+
+  EXPECT_EQ(rational{"10/-15"}, rational(-2, 3));
+  EXPECT_EQ(rational{"42"}, 42);
+  EXPECT_EQ(rational{0.375}.to_string(), "3/8");
+  EXPECT_EQ(rational{-3.0}.to_string(), "-3");
+  EXPECT_EQ(rational{0x1p-1074}.denominator(), bi_t{1} << 1074);
+  EXPECT_THROW(rational(1, 0), bi::division_by_zero);
+  EXPECT_THROW(rational{"1/0"}, bi::division_by_zero);
+  EXPECT_THROW(rational{"1/"}, std::invalid_argument);
+  EXPECT_THROW(rational{std::nan("")}, bi::from_float);
+}
+
+TEST_F(BITest, RationalArithmetic) {
+  using bi::rational;
+
+  const rational a{1, 6};
+  const rational b{3, 10};
+
+  EXPECT_EQ((a + b).to_string(), "7/15");
+  EXPECT_EQ((a - b).to_string(), "-2/15");
+  EXPECT_EQ((a * b).to_string(), "1/20");
+  EXPECT_EQ((a / b).to_string(), "5/9");
+  EXPECT_EQ((a / -b).to_string(), "-5/9");
+  EXPECT_EQ(-a + a, 0);
+  EXPECT_THROW(a / rational{}, bi::division_by_zero);
+
+  // Equal denominators only add the numerators
+  rational c = rational{1, 4} + rational{1, 4};
+  EXPECT_EQ(c.denominator(), 4);
+  EXPECT_FALSE(c.normalized());
+  EXPECT_EQ(c, rational(1, 2));
+
+  // Cross-cancellation keeps products of normalized values normalized
+  rational d = rational{bi_t{1} << 100, 3}.normalize() *
+               rational{9, bi_t{1} << 99}.normalize();
+  EXPECT_TRUE(d.normalized());
+  EXPECT_EQ(d.numerator(), 6);
+  EXPECT_EQ(d.denominator(), 1);
+
+  rational e{2, 3};
+  e.normalize();
+  e *= e;
+  e += 1;
+  EXPECT_TRUE(e.normalized());
+  EXPECT_EQ(e.to_string(), "13/9");
+  e -= e;
+  EXPECT_EQ(e, 0);
+
+  // Harmonic number H_50, without normalizing intermediate sums
+  rational h;
+  for (int i = 1; i <= 50; ++i) {
+    h += rational{1, i};
+  }
+  EXPECT_EQ(h.to_string(),
+            "13943237577224054960759/3099044504245996706400");
+
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  std::uniform_int_distribution<int> dist(1, 6);
+
+  for (int i = 0; i < 100; ++i) {
+    const rational x{bi::h_::random_(bi_dwidth * dist(rng)),
+                     bi::h_::random_(bi_dwidth * dist(rng)) + 1};
+    const rational y{-bi::h_::random_(bi_dwidth * dist(rng)),
+                     bi::h_::random_(bi_dwidth * dist(rng)) + 1};
+
+    ASSERT_EQ(x + y - y, x);
+    if (y != 0) {
+      ASSERT_EQ(x * y / y, x);
+    }
+    rational p = x * y;
+    p.normalize();
+    ASSERT_EQ(bi::gcd(p.numerator(), p.denominator()), 1);
+  }
+}
+
+TEST_F(BITest, RationalComparison) {
+  using bi::rational;
+
+  EXPECT_LT(rational(1, 3), rational(1, 2));
+  EXPECT_GT(rational(-1, 3), rational(-1, 2));
+  EXPECT_LT(rational(-1, 3), 0);
+  EXPECT_EQ(rational(2, 4), rational(3, 6));
+  EXPECT_NE(rational(2, 4), rational(3, 7));
+  EXPECT_GT(rational(bi_t{1} << 300, 3), rational(bi_t{1} << 10, 7));
+  EXPECT_LT(rational(-(bi_t{1} << 300), 3), rational(-(bi_t{1} << 10), 7));
+  EXPECT_LT(rational(bi_t{1} << 64, (bi_t{1} << 64) + 1), 1);
+  EXPECT_GT(rational((bi_t{1} << 64) + 1, bi_t{1} << 64), 1);
+
+  EXPECT_EQ(static_cast<double>(rational(1, 3)), 1.0 / 3);
+  EXPECT_EQ(static_cast<double>(rational(-22, 7)), -22.0 / 7);
+  EXPECT_EQ(static_cast<double>(rational(0.1)), 0.1);
+  EXPECT_EQ(static_cast<double>(rational(bi_t{1} << 2000, 3)),
+            std::numeric_limits<double>::infinity());
+  // 1 + 2^-53 lies exactly halfway between 1 and its successor; anything
+  // slightly larger rounds up
+  EXPECT_EQ(static_cast<double>(
+                rational((bi_t{1} << 53) + 1, bi_t{1} << 53)),
+            1.0);
+  EXPECT_EQ(static_cast<double>(rational(
+                (bi_t{1} << 200) + (bi_t{1} << 147) + 1, bi_t{1} << 200)),
+            std::nextafter(1.0, 2.0));
+
+  std::ostringstream oss;
+  oss << rational(-4, 6);
+  EXPECT_EQ(oss.str(), "-2/3");
+}
+
+TEST_F(BITest, SingleDigitDivision) {
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  std::uniform_int_distribution<int> dist(1, 40);
+  std::uniform_int_distribution<digit> ddist(1, bi_dmax);
+
+  const std::array<digit, 8> divisors{1,
+                                      2,
+                                      3,
+                                      10,
+                                      1000000000,
+                                      bi_dmax / 2,
+                                      bi_dmax / 2 + 1,
+                                      bi_dmax};
+
+  for (int i = 0; i < 200; ++i) {
+    const bi_t u = bi::h_::random_(bi_dwidth * dist(rng));
+    for (const digit v : divisors) {
+      const auto [q, r] = u.div(v);
+      ASSERT_EQ(q * v + r, u);
+      ASSERT_TRUE(r >= 0 && r < v);
+    }
+    const digit v = ddist(rng);
+    const auto [q, r] = u.div(v);
+    ASSERT_EQ(q * v + r, u);
+    ASSERT_TRUE(r >= 0 && r < v);
+  }
+}
+
+TEST_F(BITest, DecimalString) {
+  using bi::decimal;
+
+  decimal a{"-123.4500"};
+  EXPECT_EQ(a.coefficient(), -1234500);
+  EXPECT_EQ(a.exponent(), -4);
+  EXPECT_EQ(a.scale(), 4);
+  EXPECT_EQ(a.to_string(), "-123.4500");
+
+  EXPECT_EQ(decimal{"  +0.05"}.to_string(), "0.05");
+  EXPECT_EQ(decimal{".5"}.to_string(), "0.5");
+  EXPECT_EQ(decimal{"-.5"}.to_string(), "-0.5");
+  EXPECT_EQ(decimal{"1.5e-3"}.to_string(), "0.0015");
+  EXPECT_EQ(decimal{"1.5E3"}.to_string(), "1500");
+  EXPECT_EQ(decimal{"12e+2"}.exponent(), 2);
+  EXPECT_EQ(decimal{"0.000"}.to_string(), "0.000");
+  EXPECT_EQ(decimal(bi_t{7}, 3).to_string(), "7000");
+  EXPECT_EQ(decimal(bi_t{0}, 3).to_string(), "0");
+  EXPECT_EQ(decimal(bi_t{-7}, -3).to_string(), "-0.007");
+
+  const std::string long_str = "31415926535897932384626433832795028841971."
+                               "69399375105820974944592307816406286208998";
+  EXPECT_EQ(decimal{long_str}.to_string(), long_str);
+
+  EXPECT_THROW(decimal{""}, std::invalid_argument);
+  EXPECT_THROW(decimal{"-"}, std::invalid_argument);
+  EXPECT_THROW(decimal{"."}, std::invalid_argument);
+  EXPECT_THROW(decimal{"1.2.3"}, std::invalid_argument);
+  EXPECT_THROW(decimal{"1e"}, std::invalid_argument);
+  EXPECT_THROW(decimal{"12 "}, std::invalid_argument);
+  EXPECT_THROW(decimal{static_cast<const char*>(nullptr)},
+               std::invalid_argument);
+  EXPECT_THROW(decimal{"1e9999999999"}, bi::overflow_error);
+
+  std::ostringstream oss;
+  oss << decimal{"2.50"};
+  EXPECT_EQ(oss.str(), "2.50");
+}
+
+TEST_F(BITest, DecimalArithmetic) {
+  using bi::decimal;
+
+  const decimal a{"19.99"};
+  const decimal b{"0.015"};
+
+  EXPECT_EQ((a + b).to_string(), "20.005");
+  EXPECT_EQ((a - b).to_string(), "19.975");
+  EXPECT_EQ((b - a).to_string(), "-19.975");
+  EXPECT_EQ((a * b).to_string(), "0.29985");
+  EXPECT_EQ((a * 3).to_string(), "59.97");
+  EXPECT_EQ((-a).to_string(), "-19.99");
+
+  decimal c = a;
+  c += c;
+  EXPECT_EQ(c.to_string(), "39.98");
+  c -= decimal{"0.001"};
+  EXPECT_EQ(c.to_string(), "39.979");
+  c *= decimal{"10"};
+  EXPECT_EQ(c.to_string(), "399.790");
+
+  // Sum of 0.1 ten thousand times is exact
+  decimal sum;
+  const decimal tenth{"0.1"};
+  for (int i = 0; i < 10000; ++i) {
+    sum += tenth;
+  }
+  EXPECT_EQ(sum, 1000);
+
+  EXPECT_THROW(decimal(bi_t{1}, INT32_MAX) * decimal(bi_t{1}, 1),
+               bi::overflow_error);
+}
+
+TEST_F(BITest, DecimalRounding) {
+  using bi::decimal;
+  using bi::rounding;
+
+  struct Case {
+    const char* value;
+    rounding mode;
+    const char* expected;
+  };
+
+  const std::array<Case, 22> cases{{
+      {"2.345", rounding::half_even, "2.34"},
+      {"2.355", rounding::half_even, "2.36"},
+      {"-2.345", rounding::half_even, "-2.34"},
+      {"2.3451", rounding::half_even, "2.35"},
+      {"2.345", rounding::half_away_from_zero, "2.35"},
+      {"-2.345", rounding::half_away_from_zero, "-2.35"},
+      {"2.345", rounding::half_toward_zero, "2.34"},
+      {"2.3451", rounding::half_toward_zero, "2.35"},
+      {"2.349", rounding::toward_zero, "2.34"},
+      {"-2.349", rounding::toward_zero, "-2.34"},
+      {"2.341", rounding::away_from_zero, "2.35"},
+      {"-2.341", rounding::away_from_zero, "-2.35"},
+      {"2.349", rounding::floor, "2.34"},
+      {"-2.341", rounding::floor, "-2.35"},
+      {"2.341", rounding::ceil, "2.35"},
+      {"-2.349", rounding::ceil, "-2.34"},
+      {"2.340", rounding::away_from_zero, "2.34"},
+      {"0.004", rounding::ceil, "0.01"},
+      {"-0.004", rounding::ceil, "0.00"},
+      {"0.004", rounding::half_even, "0.00"},
+      {"0.005", rounding::half_even, "0.00"},
+      {"0.0051", rounding::half_even, "0.01"},
+  }};
+
+  for (const auto& [value, mode, expected] : cases) {
+    EXPECT_EQ(decimal{value}.with_scale(2, mode).to_string(), expected)
+        << value;
+  }
+
+  EXPECT_EQ(decimal{"12345"}.rescale(2).to_string(), "12300");
+  EXPECT_EQ(decimal{"1.5"}.rescale(-3).to_string(), "1.500");
+  EXPECT_EQ(decimal{"1"}.rescale(-3).rescale(0), 1);
+
+  // Far beyond the coefficient, without computing the power of ten
+  EXPECT_EQ(decimal{"123"}.rescale(1000000000, rounding::ceil).coefficient(),
+            1);
+  EXPECT_EQ(decimal{"-123"}.rescale(1000000000).coefficient(), 0);
+
+  EXPECT_EQ(decimal::div(decimal{"10"}, decimal{"3"}, -2).to_string(), "3.33");
+  EXPECT_EQ(decimal::div(decimal{"20"}, decimal{"3"}, -2).to_string(), "6.67");
+  EXPECT_EQ(decimal::div(decimal{"-1"}, decimal{"8"}, -2).to_string(),
+            "-0.12");
+  EXPECT_EQ(
+      decimal::div(decimal{"-1"}, decimal{"8"}, -2, rounding::floor)
+          .to_string(),
+      "-0.13");
+  EXPECT_EQ(decimal::div(decimal{"1"}, decimal{"-0.08"}, 0).to_string(),
+            "-12");
+  EXPECT_EQ(decimal::div(decimal{"1e-5"}, decimal{"3e4"}, -12).to_string(),
+            "0.000000000333");
+  EXPECT_EQ(decimal::div(decimal{"1"}, decimal{"7"}, -50).to_string(),
+            "0.14285714285714285714285714285714285714285714285714");
+  EXPECT_THROW(decimal::div(decimal{"1"}, decimal{"0.0"}, 0),
+               bi::division_by_zero);
+}
+
+TEST_F(BITest, DecimalComparison) {
+  using bi::decimal;
+
+  EXPECT_EQ(decimal{"1.5"}, decimal{"1.50"});
+  EXPECT_LT(decimal{"1.49"}, decimal{"1.5"});
+  EXPECT_GT(decimal{"-1.49"}, decimal{"-1.5"});
+  EXPECT_LT(decimal{"-0.01"}, 0);
+  EXPECT_EQ(decimal{"0.00"}, 0);
+  EXPECT_GT(decimal{"1e1000"}, decimal{"9.99e999"});
+  EXPECT_LT(decimal{"1e-1000"}, decimal{"1e-999"});
+  EXPECT_GT(decimal(bi_t{1}, 2000000000), decimal{"1e1000"});
+  EXPECT_LT(decimal(bi_t{-1}, 2000000000), decimal{"-1e1000"});
+  EXPECT_NE(decimal{"1.000000000000000000001"}, 1);
+}
+
+TEST_F(BITest, BigfloatConstruction) {
+  using bi::bigfloat;
+  using bi::rounding;
+
+  bigfloat zero;
+  EXPECT_EQ(zero.sign(), 0);
+  EXPECT_EQ(zero.exponent(), 0);
+
+  // Canonical form has an odd mantissa
+  bigfloat x{bi_t{96}, 3};
+  EXPECT_EQ(x.mantissa(), 3);
+  EXPECT_EQ(x.exponent(), 8);
+
+  // 0b10110 rounded to 3 bits
+  EXPECT_EQ(bigfloat(bi_t{22}, 0, 3).mantissa(), 3);
+  EXPECT_EQ(bigfloat(bi_t{22}, 0, 3).exponent(), 3);
+  EXPECT_EQ(bigfloat(bi_t{22}, 0, 3, rounding::toward_zero).mantissa(), 5);
+  EXPECT_EQ(bigfloat(bi_t{-22}, 0, 3, rounding::floor).mantissa(), -3);
+  EXPECT_EQ(bigfloat(bi_t{-22}, 0, 3, rounding::ceil).mantissa(), -5);
+  // 0b10100 is a tie between 0b10000 and 0b11000
+  EXPECT_EQ(bigfloat(bi_t{20}, 0, 2).mantissa(), 1);
+  EXPECT_EQ(bigfloat(bi_t{20}, 0, 2, rounding::half_away_from_zero).mantissa(),
+            3);
+
+  EXPECT_EQ(static_cast<double>(bigfloat{0.1}), 0.1);
+  EXPECT_EQ(static_cast<double>(bigfloat{-1e300}), -1e300);
+  EXPECT_EQ(static_cast<double>(bigfloat{0x1p-1074}), 0x1p-1074);
+  EXPECT_EQ(static_cast<double>(bigfloat(bi_t{1}, 5000)),
+            std::numeric_limits<double>::infinity());
+  EXPECT_EQ(static_cast<double>(bigfloat(bi_t{1}, -5000)), 0.0);
+  EXPECT_EQ(static_cast<double>(bigfloat(0.1, 4)), 0.1015625);
+  EXPECT_THROW(bigfloat(std::nan("")), bi::from_float);
+  EXPECT_THROW(bigfloat(1.0, 0), std::invalid_argument);
+
+  // Exponents are limited to [-2^61, 2^61]
+  constexpr int64_t max_exp = int64_t{1} << 61;
+  const bigfloat huge(bi_t{1}, max_exp);
+  const bigfloat tiny(bi_t{-3}, -max_exp);
+  EXPECT_EQ(bigfloat(bi_t{2}, max_exp - 1), huge);
+  EXPECT_THROW(bigfloat(bi_t{2}, max_exp), bi::overflow_error);
+  EXPECT_THROW(bigfloat(bi_t{1}, -max_exp - 1), bi::overflow_error);
+  EXPECT_THROW(bigfloat(bi_t{4}, INT64_MAX), bi::overflow_error);
+  EXPECT_THROW(bigfloat(bi_t{1}, INT64_MIN), bi::overflow_error);
+  EXPECT_EQ(huge * tiny, bigfloat(-3.0));
+  EXPECT_EQ(huge / huge, bigfloat(1.0));
+  EXPECT_THROW(huge * huge, bi::overflow_error);
+  EXPECT_THROW(tiny * tiny, bi::overflow_error);
+  EXPECT_THROW(huge / tiny, bi::overflow_error);
+  EXPECT_THROW(tiny / huge, bi::overflow_error);
+  // Long operands take the short product
+  const bigfloat long_huge((bi_t{1} << 300) + 1, max_exp - 300, 400);
+  EXPECT_THROW(bigfloat::mul(long_huge, long_huge, 10), bi::overflow_error);
+
+  EXPECT_EQ(bigfloat(bi_t{1}, 0, 200).to_string(5), "1.0000e+0");
+  EXPECT_EQ(bigfloat(-1234.5).to_string(3), "-1.23e+3");
+  EXPECT_EQ(bigfloat(0.000999999).to_string(2), "1.0e-3");
+  EXPECT_EQ(bigfloat(0.1).to_string(), "1.0000000000000001e-1");
+  EXPECT_EQ(bigfloat(0.1, 200).to_string(25), "1.000000000000000055511151e-1");
+
+  std::ostringstream oss;
+  oss << bigfloat(2.5);
+  EXPECT_EQ(oss.str(), "2.5000000000000000e+0");
+}
+
+TEST_F(BITest, BigfloatArithmetic) {
+  using bi::bigfloat;
+  using bi::rational;
+  using bi::rounding;
+
+  EXPECT_EQ(bigfloat(0.5) + bigfloat(0.25), bigfloat(0.75));
+  EXPECT_EQ(bigfloat(0.5) - bigfloat(0.5), bigfloat());
+  EXPECT_EQ(bigfloat(1.5) * bigfloat(-3.0), bigfloat(-4.5));
+  EXPECT_EQ(bigfloat(1.0) / bigfloat(4.0), bigfloat(0.25));
+  EXPECT_EQ(static_cast<double>(bigfloat(1.0) / bigfloat(3.0)), 1.0 / 3);
+  EXPECT_EQ(static_cast<double>(bigfloat::sqrt(bigfloat(2.0))), std::sqrt(2.0));
+  EXPECT_EQ(bigfloat::sqrt(bigfloat(bi_t{1}, 1000, 10)),
+            bigfloat(bi_t{1}, 500));
+  EXPECT_THROW(bigfloat(1.0) / bigfloat(), bi::division_by_zero);
+  EXPECT_THROW(bigfloat::sqrt(bigfloat(-1.0)), std::invalid_argument);
+
+  // Far operands only contribute a sticky bit
+  const bigfloat one(1.0, 10);
+  const bigfloat tiny(bi_t{1}, -1000, 10);
+  EXPECT_EQ(bigfloat::add(one, tiny, 10), one);
+  EXPECT_EQ(bigfloat::add(one, tiny, 10, rounding::ceil),
+            bigfloat(bi_t{513}, -9));
+  EXPECT_EQ(bigfloat::sub(one, tiny, 10, rounding::toward_zero),
+            bigfloat(bi_t{1023}, -10));
+  EXPECT_EQ(bigfloat::sub(tiny, one, 10, rounding::floor),
+            bigfloat(bi_t{-1}, 0));
+
+  // Checks against exact rational results
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  std::uniform_int_distribution<bi_bitcount_t> pdist(1, 300);
+  const std::array<rounding, 3> modes{rounding::floor, rounding::ceil,
+                                      rounding::half_even};
+
+  for (int i = 0; i < 300; ++i) {
+    const bi_bitcount_t p = pdist(rng);
+    const bigfloat a = random_bigfloat(rng, pdist(rng));
+    const bigfloat b = random_bigfloat(rng, pdist(rng));
+    const rational ra = to_rational(a);
+    const rational rb = to_rational(b);
+
+    for (const rounding mode : modes) {
+      const std::array<std::pair<bigfloat, rational>, 4> results{{
+          {bigfloat::add(a, b, p, mode), ra + rb},
+          {bigfloat::sub(a, b, p, mode), ra - rb},
+          {bigfloat::mul(a, b, p, mode), ra * rb},
+          {bigfloat::div(a, b, p, mode), ra / rb},
+      }};
+
+      for (const auto& [r, exact] : results) {
+        ASSERT_LE(r.mantissa().bit_length(), p);
+        if (exact == 0) {
+          ASSERT_EQ(r.sign(), 0);
+          continue;
+        }
+        const rational rr = to_rational(r);
+        // The neighbours of the result at precision p bracket the exact value
+        const rational below = rr - ulp(r, p);
+        const rational above = rr + ulp(r, p);
+        if (mode == rounding::floor) {
+          ASSERT_TRUE(rr <= exact && exact < above) << r << " " << exact;
+        } else if (mode == rounding::ceil) {
+          ASSERT_TRUE(below < exact && exact <= rr) << r << " " << exact;
+        } else {
+          ASSERT_TRUE((rr + below) / 2 <= exact && exact <= (rr + above) / 2)
+              << r << " " << exact;
+        }
+      }
+    }
+
+    // Square root: r^2 <= |a| < (r + ulp)^2 when rounding down
+    const bigfloat root = bigfloat::sqrt(
+        a.sign() < 0 ? -a : a, p, rounding::toward_zero);
+    const rational rr = to_rational(root);
+    const rational above = rr + ulp(root, p);
+    const rational abs_a = to_rational(a.sign() < 0 ? -a : a);
+    ASSERT_TRUE(rr * rr <= abs_a && abs_a < above * above);
+  }
+}
+
+TEST_F(BITest, BigfloatShortProduct) {
+  using bi::bigfloat;
+  using bi::rounding;
+
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  std::uniform_int_distribution<bi_bitcount_t> pdist(1, 100);
+  std::uniform_int_distribution<bi_bitcount_t> ldist(200, 3000);
+
+  for (int i = 0; i < 300; ++i) {
+    // Long operands rounded to a short precision
+    const bigfloat a = random_bigfloat(rng, ldist(rng));
+    const bigfloat b = random_bigfloat(rng, ldist(rng));
+    const bi_bitcount_t p = pdist(rng);
+
+    const bi_t exact_mantissa = a.mantissa() * b.mantissa();
+    const int64_t exact_exponent = a.exponent() + b.exponent();
+    for (const rounding mode :
+         {rounding::half_even, rounding::toward_zero, rounding::ceil}) {
+      ASSERT_EQ(bigfloat::mul(a, b, p, mode),
+                bigfloat(exact_mantissa, exact_exponent, p, mode));
+    }
+  }
+
+  // Products whose rounding is decided by bits far below the working
+  // precision require the full product
+  const bigfloat c(((bi_t{1} << 500) + 1) << 100, -600, 1000);
+  const bigfloat d((bi_t{1} << 500) - 1, -500, 1000);
+  EXPECT_EQ(bigfloat::mul(c, d, 10, rounding::floor),
+            bigfloat(bi_t{1023}, -10));
+  EXPECT_EQ(bigfloat::mul(c, d, 10, rounding::ceil), bigfloat(1.0));
+}
+
+TEST_F(BITest, ShortProducts) {
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  // Sizes on both sides of the Karatsuba threshold
+  std::uniform_int_distribution<bi_bitcount_t> bits_dist(1, 300 * bi::bi_dbits);
+
+  for (int i = 0; i < 100; ++i) {
+    bi_t a = bi::h_::random_(bits_dist(rng));
+    bi_t b = bi::h_::random_(bits_dist(rng));
+    if (i % 2) {
+      a.negate();
+    }
+    if (i % 3) {
+      b.negate();
+    }
+    const bi_t product = a * b;
+    const size_t size = a.size() + b.size();
+    std::uniform_int_distribution<size_t> n_dist(0, size + 1);
+
+    for (int j = 0; j < 4; ++j) {
+      const size_t n = n_dist(rng);
+
+      // Low product is exact
+      bi_t low = abs(product) & ((bi_t{1} << (n * bi::bi_dbits)) - 1);
+      if (product.negative()) {
+        low.negate();
+      }
+      ASSERT_EQ(bi::mul_low(a, b, n), low);
+
+      // High product is within min(a.size(), b.size()) below the exact value
+      const size_t k = size > n ? size - n : 0;
+      bi_t high = abs(product) >> (k * bi::bi_dbits);
+      const bi_t h = bi::mul_high(a, b, n);
+      if (h != 0) {
+        ASSERT_EQ(h.negative(), product.negative());
+      }
+      const bi_t diff = high - abs(h);
+      ASSERT_GE(diff, 0);
+      ASSERT_LE(diff, std::min(a.size(), b.size()));
+      if (n >= size) {
+        ASSERT_EQ(h, product);
+      }
+    }
+  }
+
+  // Edge cases
+  const bi_t x = -((bi_t{1} << 1000) - 1);
+  const bi_t square = x * x;
+  EXPECT_EQ(bi::mul_low(x, x, 1), square & bi_t{bi::bi_dmax});
+  EXPECT_EQ(bi::mul_low(x, x, 0), 0);
+  EXPECT_EQ(bi::mul_high(x, bi_t{0}, 3), 0);
+  EXPECT_EQ(bi::mul_high(x, x, 2 * x.size()), square);
+}
+
+TEST_F(BITest, ExactDivision) {
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  std::uniform_int_distribution<bi_bitcount_t> bits_dist(1, 3000);
+  std::uniform_int_distribution<bi_bitcount_t> shift_dist(0, 200);
+
+  for (int i = 0; i < 300; ++i) {
+    bi_t q = bi::h_::random_(bits_dist(rng));
+    // Divisors with factors of two, including whole zero digits
+    bi_t d = (bi::h_::random_(bits_dist(rng)) | 1) << shift_dist(rng);
+    if (i % 2) {
+      q.negate();
+    }
+    if (i % 3) {
+      d.negate();
+    }
+    const bi_t n = q * d;
+    ASSERT_EQ(bi::divexact(n, d), q);
+    ASSERT_EQ(bi::divexact(n, q == 0 ? bi_t{1} : q), q == 0 ? n : d);
+  }
+
+  EXPECT_EQ(bi::divexact(0, 7), 0);
+  EXPECT_EQ(bi::divexact(-21, 7), -3);
+  EXPECT_EQ(bi::divexact(bi_t{1} << 640, bi_t{1} << 320), bi_t{1} << 320);
+  EXPECT_EQ(bi::divexact(bi_t{bi::bi_dmax} * bi::bi_dmax, bi::bi_dmax),
+            bi::bi_dmax);
+  EXPECT_THROW(bi::divexact(1, 0), bi::division_by_zero);
+}
+
+TEST_F(BITest, DivisionInPlace) {
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  // Divisors on both sides of the stack buffer for the normalized divisor
+  std::uniform_int_distribution<bi_bitcount_t> d_bits(1, 150 * bi::bi_dbits);
+  std::uniform_int_distribution<bi_bitcount_t> q_bits(0, 100 * bi::bi_dbits);
+
+  for (int i = 0; i < 500; ++i) {
+    bi_t d = bi::h_::random_(d_bits(rng));
+    if (d == 0) {
+      continue;
+    }
+    bi_t n = d * bi::h_::random_(q_bits(rng)) + bi::h_::random_(d_bits(rng));
+    if (i % 2) {
+      n.negate();
+    }
+    if (i % 3) {
+      d.negate();
+    }
+
+    const auto [q, r] = n.div(d);
+    ASSERT_EQ(q * d + r, n);
+    ASSERT_LT(abs(r), abs(d));
+    ASSERT_TRUE(r == 0 || r.negative() == n.negative());
+
+    ASSERT_EQ(n / d, q);
+    ASSERT_EQ(n % d, r);
+    bi_t x = n;
+    x /= d;
+    ASSERT_EQ(x, q);
+    x = n;
+    x %= d;
+    ASSERT_EQ(x, r);
+  }
+
+  // The storage of the dividend is reused when it has room for one more digit
+  bi_t x = (bi_t{1} << (40 * bi::bi_dbits)) - 1;
+  x >>= 2 * bi::bi_dbits;
+  const size_t capacity = x.capacity();
+  ASSERT_GT(capacity, x.size());
+  x /= (bi_t{1} << (10 * bi::bi_dbits)) + 12345;
+  EXPECT_EQ(x.capacity(), capacity);
+  x %= bi_t{1} << (10 * bi::bi_dbits - 3);
+  EXPECT_EQ(x.capacity(), capacity);
+  x %= 7;
+  EXPECT_EQ(x.capacity(), capacity);
+
+  // Remainders by one digit, with and without a normalizing shift
+  const bi_t n = (bi_t{-1} << (5 * bi::bi_dbits)) + 98765;
+  for (const digit d : {digit{3}, digit{1} << (bi::bi_dbits - 1), bi_dmax}) {
+    x = n;
+    x %= d;
+    EXPECT_EQ(x, n - (n / d) * d);
+    EXPECT_TRUE(x <= 0);
+  }
+}
+
+TEST_F(BITest, FloorCeilEuclidDivision) {
+  // Against a reference built from truncating division
+  for (int a_in = -20; a_in <= 20; ++a_in) {
+    for (int b_in = -6; b_in <= 6; ++b_in) {
+      if (b_in == 0) {
+        continue;
+      }
+      int q = a_in / b_in;
+      int r = a_in % b_in;
+      const int q_floor = q - (r != 0 && (r < 0) != (b_in < 0));
+      const int q_ceil = q + (r != 0 && (r < 0) == (b_in < 0));
+      const int q_euclid = r < 0 ? (b_in > 0 ? q - 1 : q + 1) : q;
+
+      const bi_t a = a_in, b = b_in;
+      ASSERT_EQ(bi::div_floor(a, b), q_floor);
+      ASSERT_EQ(bi::div_ceil(a, b), q_ceil);
+      ASSERT_EQ(bi::div_euclid(a, b), q_euclid);
+      ASSERT_EQ(bi::mod_euclid(a, b), a_in - q_euclid * b_in);
+
+      const auto [qf, rf] = bi::divmod_floor(a, b);
+      ASSERT_EQ(qf, q_floor);
+      ASSERT_EQ(rf, a_in - q_floor * b_in);
+      const auto [qc, rc] = bi::divmod_ceil(a, b);
+      ASSERT_EQ(qc, q_ceil);
+      ASSERT_EQ(rc, a_in - q_ceil * b_in);
+      const auto [qe, re] = bi::divmod_euclid(a, b);
+      ASSERT_EQ(qe, q_euclid);
+      ASSERT_EQ(re, a_in - q_euclid * b_in);
+    }
+  }
+
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  std::uniform_int_distribution<bi_bitcount_t> bits_dist(1, 2000);
+  for (int i = 0; i < 200; ++i) {
+    bi_t a = bi::h_::random_(bits_dist(rng));
+    bi_t b = bi::h_::random_(bits_dist(rng)) + 1;
+    if (i % 2) {
+      a.negate();
+    }
+    if (i % 4 < 2) {
+      b.negate();
+    }
+
+    const auto [qf, rf] = bi::divmod_floor(a, b);
+    ASSERT_EQ(qf * b + rf, a);
+    ASSERT_TRUE(rf == 0 || rf.negative() == b.negative());
+    ASSERT_LT(abs(rf), abs(b));
+    ASSERT_EQ(bi::div_floor(a, b), qf);
+
+    const auto [qc, rc] = bi::divmod_ceil(a, b);
+    ASSERT_EQ(qc * b + rc, a);
+    ASSERT_TRUE(rc == 0 || rc.negative() != b.negative());
+    ASSERT_LT(abs(rc), abs(b));
+    ASSERT_EQ(bi::div_ceil(a, b), qc);
+
+    const auto [qe, re] = bi::divmod_euclid(a, b);
+    ASSERT_EQ(qe * b + re, a);
+    ASSERT_GE(re, 0);
+    ASSERT_LT(re, abs(b));
+    ASSERT_EQ(bi::div_euclid(a, b), qe);
+    ASSERT_EQ(bi::mod_euclid(a, b), re);
+  }
+
+  EXPECT_THROW(bi::div_floor(1, 0), bi::division_by_zero);
+  EXPECT_THROW(bi::mod_euclid(1, 0), bi::division_by_zero);
+  EXPECT_THROW(bi::divmod_euclid(1, 0), bi::division_by_zero);
+}
+
+TEST_F(BITest, SmallModuli) {
+  using bi::digit;
+
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  std::uniform_int_distribution<bi_bitcount_t> bits_dist(0, 2000);
+  std::uniform_int_distribution<digit> digit_dist(1, bi::bi_dmax);
+  std::uniform_int_distribution<digit> small_dist(1, 300);
+
+  for (int i = 0; i < 200; ++i) {
+    bi_t x = bi::h_::random_(bits_dist(rng));
+    if (i % 2) {
+      x.negate();
+    }
+
+    for (const digit m : {digit_dist(rng), small_dist(rng), digit{1},
+                          digit{1} << (i % bi::bi_dbits), bi::bi_dmax}) {
+      const bi_t r = bi::mod_euclid(x, m);
+      ASSERT_EQ(x.mod_ui(m), r);
+      ASSERT_EQ(x.divisible_by(m), r == 0);
+      ASSERT_TRUE((x * m).divisible_by(m));
+    }
+
+    std::vector<digit> moduli(37);
+    for (auto& m : moduli) {
+      m = i % 3 ? small_dist(rng) : digit_dist(rng);
+    }
+    std::vector<digit> residues(moduli.size());
+    x.mod_ui(moduli, residues);
+    for (size_t j = 0; j < moduli.size(); ++j) {
+      ASSERT_EQ(residues[j], x.mod_ui(moduli[j]));
+    }
+  }
+
+  EXPECT_EQ(bi_t{0}.mod_ui(7), 0);
+  EXPECT_EQ(bi_t{-1}.mod_ui(7), 6);
+  EXPECT_EQ(bi_t{-8}.mod_ui(8), 0);
+  EXPECT_TRUE(bi_t{0}.divisible_by(0));
+  EXPECT_FALSE(bi_t{5}.divisible_by(0));
+  EXPECT_TRUE((bi_t{1} << 100).divisible_by(digit{1} << (bi::bi_dbits - 1)));
+  EXPECT_FALSE(((bi_t{1} << 100) + 2).divisible_by(4));
+  EXPECT_THROW(bi_t{5}.mod_ui(0), bi::division_by_zero);
+
+  std::vector<digit> moduli{3, 0};
+  std::vector<digit> residues(2);
+  EXPECT_THROW(bi_t{5}.mod_ui(moduli, residues), bi::division_by_zero);
+  residues.resize(1);
+  EXPECT_THROW(bi_t{5}.mod_ui(moduli, residues), std::invalid_argument);
+}
+
+TEST_F(BITest, InverseMod) {
+  for (uint16_t m = 1; m < 200; ++m) {
+    for (uint16_t a = 0; a < 2 * m; ++a) {
+      const auto inv = uints::inverse_mod(a, m);
+      if (m == 1 || std::gcd(a, m) != 1) {
+        ASSERT_EQ(inv, 0);
+      } else {
+        ASSERT_LT(inv, m);
+        ASSERT_EQ(a * inv % m, 1);
+      }
+    }
+  }
+  EXPECT_EQ(uints::inverse_mod(uint64_t{3}, UINT64_MAX), 0);
+  EXPECT_EQ(uints::inverse_mod(uint64_t{2}, UINT64_MAX), uint64_t{1} << 63);
+  EXPECT_EQ(uints::inverse_mod_pow2(uint32_t{7}) * 7, 1);
+}
+
+TEST_F(BITest, ChineseRemainder) {
+  using bi::digit;
+
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  std::uniform_int_distribution<digit> digit_dist(2, bi::bi_dmax);
+
+  for (const size_t k : {0, 1, 2, 3, 7, 64, 300}) {
+    // Pairwise coprime moduli
+    std::vector<digit> moduli;
+    while (moduli.size() < k) {
+      const digit m = digit_dist(rng);
+      if (std::all_of(moduli.begin(), moduli.end(),
+                      [m](digit n) { return std::gcd(m, n) == 1; })) {
+        moduli.push_back(m);
+      }
+    }
+    const bi::crt_context ctx(moduli);
+    bi_t product = 1;
+    for (const digit m : moduli) {
+      product *= m;
+    }
+    ASSERT_EQ(ctx.modulus(), product);
+    ASSERT_EQ(ctx.size(), k);
+
+    for (int i = 0; i < 5; ++i) {
+      bi_t x = bi::h_::random_(product.bit_length() + 100);
+      if (i % 2) {
+        x.negate();
+      }
+
+      const std::vector<digit> residues = ctx.multi_mod(x);
+      for (size_t j = 0; j < k; ++j) {
+        ASSERT_EQ(residues[j], x.mod_ui(moduli[j]));
+      }
+      ASSERT_EQ(bi::multi_mod(x, moduli), residues);
+
+      const bi_t y = ctx.crt(residues);
+      ASSERT_EQ(y, bi::mod_euclid(x, product));
+      ASSERT_EQ(bi::crt(residues, moduli), y);
+    }
+  }
+
+  // Including the modulus 1
+  const std::vector<digit> moduli{4, 1, 9, 25};
+  const std::vector<digit> residues{3, 0, 8, 24};
+  EXPECT_EQ(bi::crt(residues, moduli), 899);
+
+  const std::vector<digit> not_coprime{6, 9};
+  EXPECT_THROW(bi::crt_context{not_coprime}, std::invalid_argument);
+  const std::vector<digit> zero{5, 0};
+  EXPECT_THROW(bi::crt_context{zero}, std::invalid_argument);
+  EXPECT_THROW(bi::crt(residues, not_coprime), std::invalid_argument);
+}
+
+TEST_F(BITest, NumberTheory) {
+  // powmod
+  EXPECT_EQ(bi::powmod(3, 200, 1000007),
+            bi::mod_euclid(bi_t::pow(3, 200), 1000007));
+  EXPECT_EQ(bi::powmod(-3, 3, 10), 3);
+  EXPECT_EQ(bi::powmod(5, 0, 7), 1);
+  EXPECT_EQ(bi::powmod(5, 0, -1), 0);
+  EXPECT_THROW(bi::powmod(5, -1, 7), std::invalid_argument);
+  EXPECT_THROW(bi::powmod(5, 1, 0), bi::division_by_zero);
+
+  // Jacobi symbol against Euler's criterion for small primes, and its
+  // multiplicativity in n
+  const std::vector<int> primes{3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+  for (const int p : primes) {
+    for (int a = -40; a <= 40; ++a) {
+      const bi_t euler = bi::powmod(a, (p - 1) / 2, p);
+      const int expected = euler == 0 ? 0 : (euler == 1 ? 1 : -1);
+      ASSERT_EQ(bi::jacobi(a, p), expected);
+      ASSERT_EQ(bi::kronecker(a, p), expected);
+      for (const int p2 : primes) {
+        ASSERT_EQ(bi::jacobi(a, p * p2), expected * bi::jacobi(a, p2));
+      }
+    }
+  }
+  EXPECT_EQ(bi::jacobi(5, 1), 1);
+  EXPECT_THROW(bi::jacobi(5, 8), std::invalid_argument);
+  EXPECT_THROW(bi::jacobi(5, -3), std::invalid_argument);
+
+  // Multiple-precision operands
+  const bi_t m127 = (bi_t{1} << 127) - 1;
+  const bi_t m61 = (bi_t{1} << 61) - 1;
+  for (int i = 0; i < 50; ++i) {
+    const bi_t a = bi::h_::random_(300);
+    const bi_t euler = bi::powmod(a, m127 >> 1, m127);
+    ASSERT_EQ(bi::jacobi(a, m127), euler == 0 ? 0 : (euler == 1 ? 1 : -1));
+    ASSERT_EQ(bi::jacobi(a, m127 * m61),
+              bi::jacobi(a, m127) * bi::jacobi(a, m61));
+  }
+
+  // Kronecker symbol for even and negative n
+  EXPECT_EQ(bi::kronecker(3, 2), -1);
+  EXPECT_EQ(bi::kronecker(7, 2), 1);
+  EXPECT_EQ(bi::kronecker(-5, 4), 1);
+  EXPECT_EQ(bi::kronecker(6, 4), 0);
+  EXPECT_EQ(bi::kronecker(-1, -1), -1);
+  EXPECT_EQ(bi::kronecker(2, -1), 1);
+  EXPECT_EQ(bi::kronecker(-1, 0), 1);
+  EXPECT_EQ(bi::kronecker(2, 0), 0);
+  EXPECT_EQ(bi::kronecker(5, -24), bi::kronecker(5, 8) * bi::kronecker(5, 3));
+
+  // Square roots for p = 3 (mod 4), 5 (mod 8) and 1 (mod 8), the last two
+  // with many factors of two in p - 1
+  const std::vector<bi_t> sqrt_primes{
+      7,
+      13,
+      17,
+      m127,
+      (bi_t{1} << 255) - 19,
+      (bi_t{1} << 64) - (bi_t{1} << 32) + 1,
+      (bi_t{1} << 224) - (bi_t{1} << 96) + 1};
+  for (const bi_t& p : sqrt_primes) {
+    for (int i = 0; i < 20; ++i) {
+      const bi_t r = bi::mod_euclid(bi::h_::random_(p.bit_length() + 10), p);
+      const bi_t a = r * r;
+      const bi_t x = bi::sqrtmod(a, p);
+      ASSERT_EQ(bi::mod_euclid(x * x - a, p), 0);
+      ASSERT_LE(x, p >> 1);
+      ASSERT_TRUE(x == bi::mod_euclid(r, p) || x == p - bi::mod_euclid(r, p));
+    }
+  }
+  EXPECT_EQ(bi::sqrtmod(0, 13), 0);
+  EXPECT_EQ(bi::sqrtmod(-1, 13), 5);
+  EXPECT_THROW(bi::sqrtmod(2, 13), std::invalid_argument);
+  EXPECT_THROW(bi::sqrtmod(3, 7), std::invalid_argument);
+  // Odd squares p = 1 (mod 8) have no non-residue for Tonelli-Shanks
+  EXPECT_THROW(bi::sqrtmod(1, 9), std::invalid_argument);
+  for (const int p : {25, 49, 81}) {
+    EXPECT_THROW(bi::sqrtmod(1, p), std::invalid_argument);
+  }
+}
+
+TEST_F(BITest, PolynomialMultiplication) {
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  std::uniform_int_distribution<size_t> len_dist(1, 40);
+  std::uniform_int_distribution<bi_bitcount_t> bits_dist(0, 4 * bi::bi_dbits);
+  std::uniform_int_distribution<int> sign_dist(0, 2);
+
+  const auto naive = [](const std::vector<bi_t>& a,
+                        const std::vector<bi_t>& b) {
+    std::vector<bi_t> c(a.size() + b.size() - 1);
+    for (size_t i = 0; i < a.size(); ++i) {
+      for (size_t j = 0; j < b.size(); ++j) {
+        c[i + j] += a[i] * b[j];
+      }
+    }
+    return c;
+  };
+  const auto random_poly = [&](size_t len) {
+    std::vector<bi_t> p(len);
+    for (bi_t& c : p) {
+      const int kind = sign_dist(rng);
+      if (kind != 0) {  // Leave a third of the coefficients zero
+        c = bi::h_::random_(bits_dist(rng));
+        if (kind == 2) {
+          c.negate();
+        }
+      }
+    }
+    return p;
+  };
+
+  for (int i = 0; i < 50; ++i) {
+    const std::vector<bi_t> a = random_poly(len_dist(rng));
+    const std::vector<bi_t> b = random_poly(len_dist(rng));
+    EXPECT_EQ(bi::poly_mul(a, b), naive(a, b));
+    EXPECT_EQ(bi::poly_mul(a, a), naive(a, a));
+  }
+
+  // Coefficients that fill their slots exactly
+  const bi_t max = (bi_t{1} << (3 * bi::bi_dbits)) - 1;
+  const std::vector<bi_t> ones(17, max);
+  const std::vector<bi_t> alternating{max, -max, max, -max, max};
+  EXPECT_EQ(bi::poly_mul(ones, ones), naive(ones, ones));
+  EXPECT_EQ(bi::poly_mul(ones, alternating), naive(ones, alternating));
+  EXPECT_EQ(bi::poly_mul(alternating, alternating),
+            naive(alternating, alternating));
+
+  // Zero polynomials and the empty polynomial
+  const std::vector<bi_t> zeros(3);
+  EXPECT_EQ(bi::poly_mul(zeros, alternating), std::vector<bi_t>(7));
+  EXPECT_TRUE(bi::poly_mul({}, alternating).empty());
+  EXPECT_TRUE(bi::poly_mul(alternating, {}).empty());
+  EXPECT_EQ(bi::poly_mul(std::vector<bi_t>{-3}, std::vector<bi_t>{5}),
+            std::vector<bi_t>{-15});
+}
+
+TEST_F(BITest, AddMul) {
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  // Sizes on both sides of the Karatsuba threshold
+  std::uniform_int_distribution<bi_bitcount_t> bits_dist(0, 100 * bi::bi_dbits);
+
+  for (int i = 0; i < 200; ++i) {
+    bi_t acc = bi::h_::random_(bits_dist(rng));
+    const bi_t a = bi::h_::random_(bits_dist(rng));
+    bi_t b = bi::h_::random_(bits_dist(rng));
+    if (i % 2) {
+      acc.negate();
+    }
+    if (i % 3) {
+      b.negate();
+    }
+    const bi_t expected_add = acc + a * b;
+    const bi_t expected_sub = acc - a * b;
+
+    bi_t x = acc;
+    bi::addmul(x, a, b);
+    EXPECT_EQ(x, expected_add);
+    x = acc;
+    bi::submul(x, a, b);
+    EXPECT_EQ(x, expected_sub);
+  }
+
+  // Aliased accumulator
+  bi_t x = -7;
+  bi::addmul(x, x, x);
+  EXPECT_EQ(x, 42);
+  bi::submul(x, x, 2);
+  EXPECT_EQ(x, -42);
+
+  // Carries that run past the product into the accumulator
+  x = bi_t{1} << (5 * bi::bi_dbits);
+  x -= 1;
+  bi::addmul(x, 1, 1);
+  EXPECT_EQ(x, bi_t{1} << (5 * bi::bi_dbits));
+}
+
+TEST_F(BITest, Matrix) {
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  std::uniform_int_distribution<bi_bitcount_t> bits_dist(0, 3 * bi::bi_dbits);
+
+  const auto random_matrix = [&](size_t rows, size_t cols) {
+    bi::matrix x(rows, cols);
+    for (size_t i = 0; i < rows; ++i) {
+      for (bi_t& entry : x.row(i)) {
+        entry = bi::h_::random_(bits_dist(rng));
+        if (rng() % 2) {
+          entry.negate();
+        }
+      }
+    }
+    return x;
+  };
+  const auto naive = [](const bi::matrix& a, const bi::matrix& b) {
+    bi::matrix c(a.rows(), b.cols());
+    for (size_t i = 0; i < a.rows(); ++i) {
+      for (size_t j = 0; j < b.cols(); ++j) {
+        for (size_t l = 0; l < a.cols(); ++l) {
+          c(i, j) += a(i, l) * b(l, j);
+        }
+      }
+    }
+    return c;
+  };
+
+  const bi::matrix m{{1, 2}, {3, 4}};
+  EXPECT_EQ(m * m, (bi::matrix{{7, 10}, {15, 22}}));
+  EXPECT_EQ(m * bi::matrix::identity(2), m);
+  EXPECT_EQ(m + m - m, m);
+  EXPECT_EQ(-m + m, bi::matrix(2, 2));
+  std::ostringstream os;
+  os << m;
+  EXPECT_EQ(os.str(), "[[1, 2], [3, 4]]");
+
+  // Classical and Strassen-Winograd, with odd and rectangular dimensions
+  for (const auto& [rows, inner, cols] :
+       std::vector<std::tuple<size_t, size_t, size_t>>{
+           {1, 1, 1}, {5, 3, 7}, {64, 64, 64}, {131, 67, 99}}) {
+    const bi::matrix a = random_matrix(rows, inner);
+    const bi::matrix b = random_matrix(inner, cols);
+    bi::matrix c = a;
+    c *= b;
+    EXPECT_EQ(c, naive(a, b));
+  }
+
+  EXPECT_THROW(m * bi::matrix(3, 2), std::invalid_argument);
+  EXPECT_THROW(m + bi::matrix(2, 3), std::invalid_argument);
+  EXPECT_THROW((bi::matrix{{1, 2}, {3}}), std::invalid_argument);
+  EXPECT_EQ(bi::matrix(0, 3) * bi::matrix(3, 0), bi::matrix());
+}
+
+TEST_F(BITest, CarryKernels) {
+  constexpr uint32_t max32 = std::numeric_limits<uint32_t>::max();
+  constexpr uint64_t max64 = std::numeric_limits<uint64_t>::max();
+
+  // Carries and borrows that ripple through both the unrolled loop and the tail
+  for (size_t n = 0; n <= 11; ++n) {
+    std::vector<uint32_t> a(n, max32), b(n, 0), r(n);
+    if (n != 0) {
+      b[0] = 1;
+    }
+    EXPECT_EQ(uints::add_n(r.data(), a.data(), b.data(), n), n != 0 ? 1 : 0);
+    EXPECT_EQ(r, std::vector<uint32_t>(n, 0));
+    EXPECT_EQ(uints::sub_n(r.data(), r.data(), b.data(), n), n != 0 ? 1 : 0);
+    EXPECT_EQ(r, a);
+
+    std::vector<uint64_t> x(n, max64), y(n);
+    EXPECT_EQ(uints::add_1(y.data(), x.data(), n, uint64_t{1}), 1);
+    EXPECT_EQ(y, std::vector<uint64_t>(n, 0));
+    EXPECT_EQ(uints::sub_1(y.data(), y.data(), n, uint64_t{1}), 1);
+    EXPECT_EQ(y, x);
+  }
+
+  uint64_t r64{};
+  EXPECT_EQ(uints::addcarry<uint64_t>(1, max64, 0, r64), 1);
+  EXPECT_EQ(r64, 0);
+  EXPECT_EQ(uints::subborrow<uint64_t>(1, 0, max64, r64), 1);
+  EXPECT_EQ(r64, 0);
+  uint32_t r32{};
+  EXPECT_EQ(uints::addcarry<uint32_t>(1, 5, 7, r32), 0);
+  EXPECT_EQ(r32, 13);
+  EXPECT_EQ(uints::subborrow<uint32_t>(1, 5, 7, r32), 1);
+  EXPECT_EQ(r32, max32 - 2);
+}
+
+TEST_F(BITest, AddSmallFastPaths) {
+  const bi_t base = bi_t{1} << (2 * bi::bi_dbits);
+  const std::vector<bi_t> values{0,         1,          -1,       2,
+                                 -2,        bi::bi_dmax, -bi_t{bi::bi_dmax},
+                                 base,      -base,      base - 1, -(base - 1),
+                                 base + 1,  -(base + 1)};
+
+  for (const bi_t& value : values) {
+    bi_t x = value;
+    EXPECT_EQ(++x, value + 1);
+    EXPECT_EQ(x--, value + 1);
+    EXPECT_EQ(x, value);
+    EXPECT_EQ(--x, value - 1);
+    EXPECT_EQ(x++, value - 1);
+    EXPECT_EQ(x, value);
+
+    for (const int64_t n :
+         {int64_t{0}, int64_t{1}, int64_t{-1}, int64_t{INT32_MIN},
+          int64_t{INT32_MAX}, int64_t{UINT32_MAX}, INT64_MIN, INT64_MAX}) {
+      x = value;
+      x += n;
+      EXPECT_EQ(x, value + bi_t(n));
+      x = value;
+      x -= n;
+      EXPECT_EQ(x, value - bi_t(n));
+      if (n >= INT32_MIN && n <= INT32_MAX) {
+        x = value;
+        x += static_cast<int32_t>(n);
+        EXPECT_EQ(x, value + bi_t(n));
+        x = value;
+        x -= static_cast<int32_t>(n);
+        EXPECT_EQ(x, value - bi_t(n));
+      }
+    }
+
+    x = value;
+    x += std::numeric_limits<int8_t>::min();
+    EXPECT_EQ(x, value - 128);
+    x -= uint16_t{65535};
+    EXPECT_EQ(x, value - 128 - 65535);
+    x += static_cast<unsigned char>(1);
+    EXPECT_EQ(x, value - 128 - 65534);
+    x -= std::numeric_limits<bi::digit>::max();
+    EXPECT_EQ(x, value - 128 - 65534 - bi::bi_dmax);
+  }
+
+  // Zero is never negative
+  bi_t x = -1;
+  ++x;
+  EXPECT_EQ(x.sign(), 0);
+  EXPECT_FALSE(x.negative());
+  x = 5;
+  x -= 5;
+  EXPECT_EQ(x.sign(), 0);
+  EXPECT_EQ(x.size(), 0);
+  x = -5;
+  x += 5u;
+  EXPECT_EQ(x.size(), 0);
+  EXPECT_FALSE(x.negative());
+}
+
+TEST_F(BITest, Accumulator) {
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  std::uniform_int_distribution<bi_bitcount_t> bits_dist(0, 20 * bi::bi_dbits);
+
+  for (int i = 0; i < 20; ++i) {
+    bi_t initial = bi::h_::random_(bits_dist(rng));
+    if (i % 2) {
+      initial.negate();
+    }
+    bi::accumulator acc(initial);
+    bi_t expected = initial;
+    std::vector<bi_t> values;
+    for (int j = 0; j < 200; ++j) {
+      bi_t x = bi::h_::random_(bits_dist(rng));
+      if (rng() % 2) {
+        x.negate();
+      }
+      if (rng() % 3 == 0) {
+        acc -= x;
+        expected -= x;
+      } else {
+        acc += x;
+        expected += x;
+        values.push_back(x);
+      }
+    }
+    EXPECT_EQ(acc.value(), expected);
+
+    bi_t total;
+    for (const bi_t& x : values) {
+      total += x;
+    }
+    EXPECT_EQ(bi::sum(values), total);
+  }
+
+  // Carries through every column, and sums that cancel
+  const bi_t max = (bi_t{1} << (8 * bi::bi_dbits)) - 1;
+  bi::accumulator acc;
+  for (int i = 0; i < 1000; ++i) {
+    acc += max;
+  }
+  EXPECT_EQ(acc.value(), max * 1000);
+  for (int i = 0; i < 1001; ++i) {
+    acc -= max;
+  }
+  EXPECT_EQ(acc.value(), -max);
+  acc += max;
+  EXPECT_EQ(acc.value(), 0);
+  EXPECT_EQ(acc.value().sign(), 0);
+  acc.clear();
+  acc -= 1;
+  EXPECT_EQ(acc.value(), -1);
+  EXPECT_EQ(bi::sum({}), 0);
+}
+
+TEST_F(BITest, FloatingConversions) {
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  std::uniform_int_distribution<bi_bitcount_t> bits_dist(1, 1100);
+
+  // Round to nearest, ties to even, against the correctly rounded strto*
+  for (int i = 0; i < 2000; ++i) {
+    bi_t x = bi::h_::random_(bits_dist(rng));
+    if (i % 2) {
+      x.negate();
+    }
+    const std::string str = x.to_string();
+    ASSERT_EQ(static_cast<double>(x), std::strtod(str.c_str(), nullptr));
+    ASSERT_EQ(static_cast<float>(x), std::strtof(str.c_str(), nullptr));
+    ASSERT_EQ(static_cast<long double>(x), std::strtold(str.c_str(), nullptr));
+  }
+
+  // Directed modes bracket the value
+  for (int i = 0; i < 1000; ++i) {
+    bi_t x = bi::h_::random_(bits_dist(rng) % 1000 + 1);
+    if (i % 2) {
+      x.negate();
+    }
+    const double down = x.to_double(bi::rounding::floor);
+    const double up = x.to_double(bi::rounding::ceil);
+    ASSERT_LE(bi_t(down), x);
+    ASSERT_GE(bi_t(up), x);
+    ASSERT_TRUE(down == up || std::nextafter(down, up) == up);
+    ASSERT_EQ(x.to_double(bi::rounding::toward_zero), x.negative() ? up : down);
+    ASSERT_EQ(x.to_double(bi::rounding::away_from_zero),
+              x.negative() ? down : up);
+  }
+
+  // Ties
+  const bi_t tie = (bi_t{1} << 53) + 1;  // Halfway between 2^53 and 2^53 + 2
+  EXPECT_EQ(tie.to_double(), 0x1p53);
+  EXPECT_EQ(tie.to_double(bi::rounding::half_away_from_zero), 0x1p53 + 2);
+  EXPECT_EQ(tie.to_double(bi::rounding::half_toward_zero), 0x1p53);
+  EXPECT_EQ((tie + 2).to_double(), 0x1p53 + 4);
+  EXPECT_EQ((-(tie + 2)).to_double(), -(0x1p53 + 4));
+  EXPECT_EQ((tie + (bi_t{1} << 200)).to_double(bi::rounding::half_even),
+            0x1p200);
+  // A sticky bit far below the round bit
+  const bi_t sticky = (tie << 900) + 1;
+  EXPECT_EQ(sticky.to_double(), 0x1p953 + 0x1p901);
+  EXPECT_EQ(sticky.to_double(bi::rounding::half_toward_zero),
+            0x1p953 + 0x1p901);
+
+  // Overflow
+  const bi_t huge = bi_t{1} << 1024;
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  constexpr double max = std::numeric_limits<double>::max();
+  EXPECT_EQ(static_cast<double>(huge), inf);
+  EXPECT_EQ(static_cast<double>(-huge), -inf);
+  EXPECT_EQ(huge.to_double(bi::rounding::toward_zero), max);
+  EXPECT_EQ(huge.to_double(bi::rounding::floor), max);
+  EXPECT_EQ((-huge).to_double(bi::rounding::floor), -inf);
+  EXPECT_EQ((-huge).to_double(bi::rounding::ceil), -max);
+  EXPECT_EQ(static_cast<float>(bi_t{1} << 128),
+            std::numeric_limits<float>::infinity());
+  // Rounding up into overflow
+  const bi_t below_huge = huge - 1;
+  EXPECT_EQ(static_cast<double>(below_huge), inf);
+  EXPECT_EQ(below_huge.to_double(bi::rounding::toward_zero), max);
+  EXPECT_EQ(static_cast<double>(bi_t(max)), max);
+
+  // From floating point, truncating toward zero
+  EXPECT_EQ(bi_t(0.0), 0);
+  EXPECT_EQ(bi_t(-0.75), 0);
+  EXPECT_EQ(bi_t(-0.75).negative(), false);
+  EXPECT_EQ(bi_t(-1.75), -1);
+  EXPECT_EQ(bi_t(0x1p53 + 2), (bi_t{1} << 53) + 2);
+  EXPECT_EQ(bi_t(-0x1.8p100), -(bi_t{3} << 99));
+  EXPECT_EQ(bi_t(max), ((bi_t{1} << 53) - 1) << 971);
+  EXPECT_EQ(bi_t(4503599627370495.5), 4503599627370495);
+  // 2^p + 2, where p is the precision of long double, needs all p bits
+  constexpr int ld_digits = std::numeric_limits<long double>::digits;
+  EXPECT_EQ(bi_t(std::ldexp(1.0L, ld_digits) + 2), (bi_t{1} << ld_digits) + 2);
+  EXPECT_EQ(bi_t(-0x1p200L), -(bi_t{1} << 200));
+  bi_t y;
+  y = 12345.9L;
+  EXPECT_EQ(y, 12345);
+  EXPECT_THROW(bi_t(std::numeric_limits<long double>::infinity()),
+               bi::from_float);
+  for (int i = 0; i < 1000; ++i) {
+    const bi_t x = bi::h_::random_(bits_dist(rng) % 1000 + 1);
+    const double d = static_cast<double>(x);
+    ASSERT_EQ(static_cast<double>(bi_t(d)), d);
+  }
+}
+
+TEST_F(BITest, DoubleComparisonsExact) {
+  std::random_device rdev;
+  std::mt19937 rng(rdev());
+  std::uniform_int_distribution<bi_bitcount_t> bits_dist(1, 1100);
+
+  const auto check = [](const bi_t& z, double d) {
+    if (d != std::trunc(d)) {
+      return;  // Covered below
+    }
+    // Reference: d is an integer here, so bi_t(d) is exact
+    const auto expected = z <=> bi_t(d);
+    ASSERT_EQ(z < d, expected < 0);
+    ASSERT_EQ(z == d, expected == 0);
+    ASSERT_EQ(z > d, expected > 0);
+    ASSERT_EQ(d < z, expected > 0);
+  };
+
+  for (int i = 0; i < 2000; ++i) {
+    bi_t z = bi::h_::random_(bits_dist(rng));
+    if (i % 2) {
+      z.negate();
+    }
+    const double d = z.to_double(bi::rounding::toward_zero);
+    if (std::isinf(d) || std::abs(d) == std::numeric_limits<double>::max()) {
+      continue;
+    }
+    check(z, d);
+    check(z, std::nextafter(d, 0.0));
+    check(z, std::nextafter(d, 2 * d));
+    check(z + 1, d);
+    check(z - 1, d);
+    check(bi_t(d), d);
+    check(bi_t(d) + 1, d);
+    check(bi_t(d) - 1, d);
+  }
+
+  // Fractions, the boundaries of the exact range and of the exponent range
+  EXPECT_TRUE(bi_t(2) > 1.5);
+  EXPECT_TRUE(bi_t(1) < 1.5);
+  EXPECT_TRUE(bi_t(-2) < -1.5);
+  EXPECT_TRUE(bi_t(0) > -0.5);
+  EXPECT_TRUE(bi_t(0) == -0.0);
+  const bi_t two53 = bi_t{1} << 53;
+  EXPECT_TRUE(two53 == 0x1p53);
+  EXPECT_TRUE(two53 + 1 > 0x1p53);
+  EXPECT_TRUE(two53 - 1 < 0x1p53);
+  EXPECT_TRUE(two53 - 1 == 0x1p53 - 1);
+  const bi_t huge = bi_t{1} << 1024;
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  EXPECT_TRUE(huge > std::numeric_limits<double>::max());
+  EXPECT_TRUE(huge < inf);
+  EXPECT_TRUE(-huge > -inf);
+  EXPECT_TRUE((bi_t{1} << 100000) < inf);
+  EXPECT_FALSE(huge == std::nan(""));
+  EXPECT_FALSE(huge < std::nan(""));
+}
+
+TEST_F(BITest, SmallOperandArithmetic) {
+  // Offsetting by `big` sends the reference computations down the general
+  // paths, while the operands themselves take the single-digit ones
+  const bi_t big = bi_t{1} << (3 * bi::bi_dbits);
+  const std::vector<bi_t> values{0,
+                                 1,
+                                 -1,
+                                 2,
+                                 -3,
+                                 bi::bi_dmax,
+                                 -bi_t{bi::bi_dmax},
+                                 bi_t{bi::bi_dmax} - 1,
+                                 bi_t{1} << (bi::bi_dbits - 1)};
+
+  for (const bi_t& a : values) {
+    for (const bi_t& b : values) {
+      const bi_t sum = a + b;
+      const bi_t difference = a - b;
+      const bi_t product = a * b;
+      EXPECT_EQ(sum, ((a + big) + b) - big);
+      EXPECT_EQ(difference, ((a + big) - b) - big);
+      EXPECT_EQ(product, ((a * big) * b) >> (3 * bi::bi_dbits));
+      EXPECT_EQ(a < b, (a + big) < (b + big));
+      EXPECT_EQ(a == b, (a + big) == (b + big));
+      EXPECT_EQ(a <=> b, (a - big) <=> (b - big));
+      EXPECT_EQ(sum == 0, !sum.negative() && sum.size() == 0);
+      EXPECT_EQ(difference == 0, difference.size() == 0);
+      EXPECT_FALSE(product == 0 && product.negative());
+
+      bi_t x = a;
+      x += b;
+      EXPECT_EQ(x, sum);
+      x = a;
+      x -= b;
+      EXPECT_EQ(x, difference);
+      x = a;
+      x *= b;
+      EXPECT_EQ(x, product);
+    }
+
+    // Aliased operands
+    bi_t x = a;
+    x += x;
+    EXPECT_EQ(x, a * 2);
+    x = a;
+    x -= x;
+    EXPECT_EQ(x, 0);
+    EXPECT_FALSE(x.negative());
+    x = a;
+    x *= x;
+    EXPECT_EQ(x, ((a * big) * a) >> (3 * bi::bi_dbits));
+  }
+
+  // Carries and products that need a second digit
+  const bi_t max = bi::bi_dmax;
+  EXPECT_EQ((max + 1).size(), 2);
+  EXPECT_EQ(max + max, max * 2);
+  EXPECT_EQ((-max) - max, -(max * 2));
+  EXPECT_EQ(max * max, (max << bi::bi_dbits) - max);
+  EXPECT_EQ((-max) * max, -((max << bi::bi_dbits) - max));
+  EXPECT_EQ((max * max).size(), 2);
+  EXPECT_EQ((-max) + max, 0);
+  EXPECT_EQ(max - (max + 1), -1);
+}
+
+TEST_F(BITest, ModInt) {
+  using bi::dyn_modint;
+  using bi::modint;
+  std::mt19937_64 rng(20240610);
+
+  // Checks the arithmetic of the values of type M against bi_t arithmetic
+  // modulo m, for operands drawn from `operands`
+  const auto check = [&](auto zero, const bi_t& m,
+                         const std::vector<bi_t>& operands) {
+    using M = decltype(zero);
+    const auto make = [&](const bi_t& value) {
+      if constexpr (requires { M(value); }) {
+        return M(value);
+      } else {
+        return M(zero.context(), value);
+      }
+    };
+    for (const bi_t& a : operands) {
+      const M x = make(a);
+      EXPECT_EQ(x.value(), bi::mod_euclid(a, m));
+      for (const bi_t& b : operands) {
+        const M y = make(b);
+        EXPECT_EQ((x + y).value(), bi::mod_euclid(a + b, m));
+        EXPECT_EQ((x - y).value(), bi::mod_euclid(a - b, m));
+        EXPECT_EQ((x * y).value(), bi::mod_euclid(a * b, m));
+        EXPECT_EQ(x == y, bi::mod_euclid(a - b, m) == 0);
+        if (bi::gcd(b, m) == 1) {
+          EXPECT_EQ((x / y * y).value(), bi::mod_euclid(a, m));
+        }
+      }
+      EXPECT_EQ((-x).value(), bi::mod_euclid(-a, m));
+      EXPECT_EQ(x.pow(0).value(), bi::mod_euclid(1, m));
+      EXPECT_EQ(x.pow(37).value(), bi::powmod(bi::mod_euclid(a, m), 37, m));
+      const bi_t big_exp = (bi_t{1} << 200) + 12345;
+      EXPECT_EQ(x.pow(big_exp).value(),
+                bi::powmod(bi::mod_euclid(a, m), big_exp, m));
+      if (bi::gcd(a, m) == 1) {
+        EXPECT_EQ(x.inv() * x, make(1));
+        EXPECT_EQ(x.pow(-3) * x.pow(3), make(1));
+        EXPECT_EQ(x.pow(bi_t{-5}) * x.pow(5), make(1));
+      } else {
+        EXPECT_THROW(x.inv(), bi::division_by_zero);
+      }
+    }
+  };
+
+  const auto operands = [&](const bi_t& m) {
+    std::vector<bi_t> r{0, 1, -1, 2, m - 1, m, m + 1, -m, m * m + 3};
+    for (int i = 0; i < 6; ++i) {
+      r.push_back(bi::h_::random_(m.bit_length() + 8) - (m << 4));
+    }
+    return r;
+  };
+
+  // Compile-time moduli: one digit, a 64-bit prime and a prime of 127 bits
+  // given by its digits
+  constexpr size_t w = std::numeric_limits<bi::digit>::digits;
+  constexpr auto m127 = [] {
+    std::array<bi::digit, 128 / w> digits{};
+    digits.fill(std::numeric_limits<bi::digit>::max());
+    digits.back() >>= 1;
+    return digits;
+  }();
+  const bi_t p127 = (bi_t{1} << 127) - 1;
+  check(modint<998244353>{}, 998244353, operands(998244353));
+  check(modint<0xffffffff00000001ULL>{}, 0xffffffff00000001ULL,
+        operands(0xffffffff00000001ULL));
+  check(modint<m127>{}, p127, operands(p127));
+  EXPECT_EQ(modint<m127>::modulus(), p127);
+  static_assert(modint<7>::size == 1);
+  static_assert(modint<m127>::size == 128 / w);
+
+  modint<7> x = 3;
+  EXPECT_EQ(x.inv().value(), 5);
+  EXPECT_EQ((x / 2).value(), 5);
+  EXPECT_EQ(modint<7>(-1).value(), 6);
+  EXPECT_EQ(modint<7>(INT64_MIN).value(), bi::mod_euclid(INT64_MIN, 7));
+  x *= 5;
+  EXPECT_EQ(x, modint<7>(1));
+  std::ostringstream os;
+  os << x;
+  EXPECT_EQ(os.str(), "1");
+
+  // Run-time moduli, including composites, moduli with fewer digits than
+  // the storage, and 1
+  const dyn_modint<4>::context_type ctx127(p127);
+  check(dyn_modint<4>(ctx127), p127, operands(p127));
+  for (const bi_t& m : {bi_t{1}, bi_t{3}, bi_t{15}, bi_t{1000001},
+                        (bi_t{1} << 100) + 277, p127 * 3}) {
+    const dyn_modint<8>::context_type ctx(m);
+    check(dyn_modint<8>(ctx), m, operands(m));
+  }
+  const dyn_modint<>::context_type ctx15(15);
+  EXPECT_EQ(dyn_modint<>(ctx15, 2).inv().value(), 8);
+  EXPECT_THROW(dyn_modint<>(ctx15, 3).inv(), bi::division_by_zero);
+  EXPECT_THROW(dyn_modint<>(ctx15, 1) / dyn_modint<>(ctx15, 5),
+               bi::division_by_zero);
+
+  EXPECT_THROW(dyn_modint<>::context_type{bi_t{16}}, std::invalid_argument);
+  EXPECT_THROW(dyn_modint<>::context_type{bi_t{-3}}, std::invalid_argument);
+  EXPECT_THROW(dyn_modint<>::context_type{bi_t{0}}, std::invalid_argument);
+  EXPECT_THROW(dyn_modint<1>::context_type{p127}, std::invalid_argument);
+}
+
+TEST_F(BITest, HashAndIntern) {
+  const bi_t big = bi_t::pow(10, 300);
+  const std::vector<bi_t> values{0, 1, -1, bi::bi_dmax, -bi_t{bi::bi_dmax},
+                                 big, -big, big + 1, big << 1};
+
+  // Equal integers hash equally, regardless of capacity
+  bi_t grown = big;
+  grown <<= 1000;
+  grown >>= 1000;
+  EXPECT_EQ(std::hash<bi_t>{}(grown), std::hash<bi_t>{}(big));
+  const std::unordered_set<bi_t> set(values.begin(), values.end());
+  EXPECT_EQ(set.size(), values.size());
+  for (const bi_t& x : values) {
+    EXPECT_TRUE(set.contains(x));
+  }
+
+  const size_t before = bi::interned_count();
+  {
+    std::vector<bi::interned> handles;
+    for (const bi_t& x : values) {
+      handles.push_back(bi::intern(x));
+      EXPECT_EQ(*handles.back(), x);
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+      const bi::interned again = bi::intern(bi_t(values[i]));
+      EXPECT_EQ(again, handles[i]);
+      EXPECT_EQ(&*again, &*handles[i]);
+      for (size_t j = 0; j < values.size(); ++j) {
+        EXPECT_EQ(handles[i] == handles[j], i == j);
+      }
+    }
+    EXPECT_EQ(bi::interned() == bi::intern(0), true);
+    EXPECT_EQ(handles[5]->to_string(), big.to_string());
+    std::ostringstream os;
+    os << handles[2];
+    EXPECT_EQ(os.str(), "-1");
+    const std::unordered_set<bi::interned> handle_set(handles.begin(),
+                                                      handles.end());
+    EXPECT_EQ(handle_set.size(), values.size());
+    EXPECT_GE(bi::interned_count(), before + values.size() - 1);
+  }
+  // Integers are removed with their last handle
+  EXPECT_EQ(bi::interned_count(), before);
+
+  // Concurrent interning of the same integers yields the same handles
+  constexpr size_t n_threads = 8;
+  constexpr int n_values = 200;
+  std::vector<std::vector<bi::interned>> results(n_threads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < n_threads; ++t) {
+    threads.emplace_back([&results, &big, t]() {
+      for (int round = 0; round < 5; ++round) {
+        results[t].clear();
+        for (int i = 0; i < n_values; ++i) {
+          results[t].push_back(bi::intern(big * i));
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (size_t t = 1; t < n_threads; ++t) {
+    EXPECT_EQ(results[t], results[0]);
+  }
+  for (int i = 0; i < n_values; ++i) {
+    EXPECT_EQ(*results[0][i], big * i);
+  }
+  results.clear();
+  EXPECT_EQ(bi::interned_count(), before);
+}
+
+TEST_F(BITest, PowerCacheConversions) {
+  using bi::power_cache;
+  std::mt19937 rng(20240612);
+
+  // Horner's rule, as a reference for the divide-and-conquer parser
+  const auto horner = [](const std::string& s, int base) {
+    bi_t r;
+    for (const char ch : s) {
+      const int d = std::isdigit(ch) ? ch - '0' : ch - 'a' + 10;
+      r = r * base + d;
+    }
+    return r;
+  };
+  constexpr std::string_view chars = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+  for (const int base : {2, 3, 10, 16, 36}) {
+    for (const size_t length : {1000, 4097, 12000}) {
+      std::string s(length, '0');
+      for (char& ch : s) {
+        ch = chars[rng() % base];
+      }
+      s[0] = '1';
+      // Runs of zeros, which formatting must pad
+      std::fill(s.begin() + static_cast<ptrdiff_t>(length / 3),
+                s.begin() + static_cast<ptrdiff_t>(length / 3 + length / 4),
+                '0');
+      const bi_t x(s, base);
+      EXPECT_EQ(x, horner(s, base));
+      EXPECT_EQ(x.to_string(base), s);
+      EXPECT_EQ((-x).to_string(base), "-" + s);
+      EXPECT_EQ(bi_t("-" + s, base), -x);
+    }
+  }
+  const bi_t p = bi_t::pow(10, 5000);
+  EXPECT_EQ(p.to_string(), "1" + std::string(5000, '0'));
+  EXPECT_EQ((p - 1).to_string(), std::string(5000, '9'));
+
+  // Powers of small bases, against repeated multiplication
+  for (const int base : {-36, -10, -3, 2, 3, 7, 10, 36}) {
+    bi_t expected = 1;
+    for (bi::bi_bitcount_t exp = 0; exp < 300; ++exp) {
+      EXPECT_EQ(bi_t::pow(base, exp), expected);
+      expected *= base;
+    }
+    EXPECT_EQ(bi_t::pow(base, bi_t{299}), expected / base);
+  }
+
+  EXPECT_EQ(*power_cache::get(10, 3), 100000000);
+  EXPECT_GT(power_cache::usage(), 0);
+  EXPECT_LE(power_cache::usage(), power_cache::limit());
+
+  // A limit that cannot hold the powers needed, shared by threads converting
+  // in different bases: powers are evicted and recomputed, or not cached
+  power_cache::set_limit(4096);
+  EXPECT_LE(power_cache::usage(), 4096);
+  std::vector<std::thread> threads;
+  std::vector<int> failures(6, 0);
+  for (int t = 0; t < 6; ++t) {
+    threads.emplace_back([&failures, t]() {
+      const int base = 3 + 5 * t;
+      for (int i = 0; i < 4; ++i) {
+        const bi_t x = bi_t::pow(base, 3000 + 100 * i) - 1;
+        if (bi_t(x.to_string(base), base) != x) {
+          ++failures[t];
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(failures, std::vector<int>(6, 0));
+  EXPECT_LE(power_cache::usage(), 4096);
+
+  power_cache::set_limit(0);
+  EXPECT_EQ(power_cache::usage(), 0);
+  EXPECT_EQ(bi_t::pow(10, 1000).to_string(), "1" + std::string(1000, '0'));
+  EXPECT_EQ(power_cache::usage(), 0);
+
+  power_cache::set_limit(power_cache::default_limit);
+  EXPECT_EQ(bi_t::pow(3, 1000), horner("1" + std::string(1000, '0'), 3));
+  EXPECT_GT(power_cache::usage(), 0);
+  power_cache::clear();
+  EXPECT_EQ(power_cache::usage(), 0);
+}
+
+TEST_F(BITest, PowerOfTwoFastPaths) {
+  EXPECT_FALSE(bi_t(0).is_pow2());
+  EXPECT_TRUE(bi_t(1).is_pow2());
+  EXPECT_TRUE(bi_t(-1).is_pow2());
+  EXPECT_TRUE(bi_t(64).is_pow2());
+  EXPECT_FALSE(bi_t(96).is_pow2());
+  EXPECT_TRUE((bi_t(-1) << 200).is_pow2());
+  EXPECT_FALSE(((bi_t(1) << 200) + 1).is_pow2());
+  EXPECT_FALSE(((bi_t(1) << 200) - 1).is_pow2());
+
+  const std::vector<bi_t> values = {
+      0,
+      1,
+      -1,
+      12345,
+      -12345,
+      bi_t("123456789012345678901234567890123456789012345678901234567890"),
+      bi_t("-98765432109876543210987654321098765432109876543210987654321"),
+      (bi_t(1) << 300) - 1,
+      -(bi_t(1) << 300),
+  };
+  const std::vector<bi_bitcount_t> exps = {0, 1, 5, 31, 32, 33, 63, 64, 65,
+                                           100, 299, 300, 301, 500};
+
+  for (const bi_t& x : values) {
+    for (const bi_bitcount_t k : exps) {
+      for (const bool negative : {false, true}) {
+        const bi_t p = negative ? -(bi_t(1) << k) : bi_t(1) << k;
+        // Dividing 3x by 3p takes the general path, with the same quotient
+        // and three times the remainder
+        const bi_t q = (x * 3) / (p * 3);
+        const bi_t r = (x * 3) % (p * 3) / 3;
+
+        EXPECT_EQ(x * p, negative ? -(x << k) : x << k);
+        EXPECT_EQ(p * x, x * p);
+        EXPECT_EQ(x / p, q);
+        EXPECT_EQ(x % p, r);
+        EXPECT_EQ(x.div(p), std::make_pair(q, r));
+        EXPECT_EQ(bi::div_floor(x, p), bi::div_floor(x * 3, p * 3));
+        EXPECT_EQ(bi::mod_euclid(x, p), bi::mod_euclid(x * 3, p * 3) / 3);
+
+        bi_t y = x;
+        y *= p;
+        EXPECT_EQ(y, x * p);
+        y = x;
+        y /= p;
+        EXPECT_EQ(y, q);
+        y = x;
+        y %= p;
+        EXPECT_EQ(y, r);
+      }
+
+      const bi_t p = bi_t(1) << k;
+      bi_t y = x;
+      EXPECT_EQ(y.mod_pow2(k), x % p);
+      y = x;
+      EXPECT_EQ(y.div_pow2_trunc(k), x / p);
+      y = x;
+      EXPECT_EQ(y.div_pow2_floor(k), x >> k);
+      EXPECT_EQ(y, bi::div_floor(x, p));
+    }
+  }
+
+  // The power of two as the product, which aliases it
+  bi_t x("-123456789012345678901234567890");
+  bi_t p = bi_t(1) << 40;
+  p *= x;
+  EXPECT_EQ(p, x << 40);
+  p = bi_t(1) << 40;
+  p *= p;
+  EXPECT_EQ(p, bi_t(1) << 80);
+
+  // In place, without allocating
+  x = (bi_t(1) << 1000) + 12345;
+  size_t capacity = x.capacity();
+  x.mod_pow2(700);
+  EXPECT_EQ(x, 12345);
+  EXPECT_EQ(x.capacity(), capacity);
+  x = -((bi_t(1) << 1000) + 1);
+  capacity = x.capacity();
+  x.div_pow2_floor(1);
+  EXPECT_EQ(x, -(bi_t(1) << 999) - 1);
+  x.div_pow2_trunc(990);
+  EXPECT_EQ(x, -512);
+  EXPECT_EQ(x.capacity(), capacity);
+}
+
+TEST_F(BITest, ParallelExecution) {
+  namespace parallel = bi::parallel;
+
+  EXPECT_GE(parallel::node_count(), 1);
+  EXPECT_LT(parallel::current_node(), parallel::node_count());
+
+  // Every index once, for any split of threads over worker groups, including
+  // more groups than the machine has NUMA nodes
+  for (const size_t n : {0, 1, 2, 3, 7, 100}) {
+    for (const size_t threads : {1, 2, 3, 5}) {
+      for (const size_t nodes : {1, 2, 3, 4}) {
+        std::vector<std::atomic<int>> visits(n);
+        parallel::for_each_index_on_nodes(
+            n, [&visits](size_t i) { ++visits[i]; }, threads, nodes);
+        for (size_t i = 0; i < n; ++i) {
+          EXPECT_EQ(visits[i], 1) << n << " " << threads << " " << nodes;
+        }
+      }
+    }
+  }
+
+  std::atomic<int> calls{0};
+  EXPECT_THROW(parallel::for_each_index_on_nodes(
+                   50,
+                   [&calls](size_t i) {
+                     ++calls;
+                     if (i == 10) {
+                       throw std::runtime_error("failed");
+                     }
+                   },
+                   4, 2),
+               std::runtime_error);
+  EXPECT_LE(calls, 50);
+
+  // The parallel Karatsuba product, which only runs on machines with several
+  // threads, against the schoolbook product. Both leave the sign to mul().
+  for (const auto& [m, n] : std::vector<std::pair<size_t, size_t>>{
+           {4096, 4096}, {5000, 4200}, {4100, 9000}}) {
+    const bi_t a = bi::h_::random_(m * bi_dwidth);
+    const bi_t b = -bi::h_::random_(n * bi_dwidth);
+    bi_t expected;
+    bi::h_::mul_standard(expected, a, b);  // |a| * |b|
+    bi_t product;
+    bi::h_::mul_karatsuba_parallel(product, a, b, std::min(m, n) / 2);
+    EXPECT_EQ(product, expected);
+    EXPECT_EQ(a * b, -expected);
+
+    bi_t aliased = a;
+    bi::h_::mul_karatsuba_parallel(aliased, aliased, b, std::min(m, n) / 2);
+    EXPECT_EQ(aliased, expected);
+  }
+
+  // Radix conversions of integers above the parallel threshold
+  const bi_t x = -bi::h_::random_(5000 * bi_dwidth);
+  EXPECT_EQ(bi_t(x.to_string()), x);
+  EXPECT_EQ(bi_t(x.to_string(7), 7), x);
+}
+
+TEST_F(BITest, HugePageAllocation) {
+  const bi::allocation_policy defaults = bi::get_allocation_policy();
+  EXPECT_EQ(defaults.huge_page_threshold, size_t{8} << 20);
+  EXPECT_FALSE(defaults.explicit_huge_pages);
+
+  // The allocation method is kept with the capacity, at no cost in size
+  EXPECT_EQ(sizeof(bi::dvector), sizeof(digit*) + 2 * sizeof(size_t));
+
+  const auto is_huge_page_aligned = [](const bi_t& x) {
+    return reinterpret_cast<uintptr_t>(x.digits().data()) %  // NOLINT
+               (size_t{2} << 20) ==
+           0;
+  };
+
+  for (const bool explicit_pages : {false, true}) {
+    bi::set_allocation_policy({size_t{1} << 20, explicit_pages});
+    EXPECT_EQ(bi::get_allocation_policy().huge_page_threshold, size_t{1} << 20);
+
+    // 2^{2^23} has 2^23 / bi_dwidth + 1 digits, over 1 MiB
+    const bi_bitcount_t bits = bi_bitcount_t{1} << 23;
+    bi_t x = bi_t(1) << bits;
+    EXPECT_GE(x.capacity() * sizeof(digit), size_t{1} << 20);
+#if defined(__linux__)
+    EXPECT_TRUE(is_huge_page_aligned(x));
+#endif
+    bi_t y = x - 1;
+    EXPECT_EQ(y.bit_length(), bits);
+    EXPECT_EQ(y + 1, x);
+
+    // Copies, moves and growth from small arrays
+    bi_t copy = y;
+    EXPECT_EQ(copy, y);
+    bi_t moved = std::move(copy);
+    EXPECT_EQ(moved, y);
+    EXPECT_EQ(copy.capacity(), 0);  // NOLINT(bugprone-use-after-move)
+    bi_t small = 3;
+    small <<= bits;
+    EXPECT_EQ(small, x * 3);
+    small = 5;
+    EXPECT_EQ(small, 5);
+    moved = bi_t(7);
+    EXPECT_EQ(moved, 7);
+
+    // Arrays mapped under one policy are freed correctly under another
+    bi::set_allocation_policy({SIZE_MAX, false});
+    bi_t z = x;
+    EXPECT_EQ(z, x);
+    y = std::move(z);
+    x = 0;
+  }
+
+  bi::set_allocation_policy(defaults);
+}
+
 // NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
 
 }  // namespace